@@ -0,0 +1,46 @@
+#ifndef _DEBOUNCER_H_
+#define _DEBOUNCER_H_
+
+#include "timer.h"
+
+namespace CTimer {
+
+    /**
+     * @brief 防抖
+     *
+     * 最后一次触发之后经过 delay 毫秒没有新的触发时执行一次回调。
+     * 只持有一个定时任务节点，空闲时触发放入时间轮，已激活时触发只延后节点的到期时间，
+     * 连续触发不会分配内存，也不会重复插入时间轮
+     */
+    template <typename T, typename Layout = RuntimeWheelLayout, typename Overflow = TimerHeap<TimerEntry<T>>>
+    class Debouncer {
+    public:
+        /**
+         * @brief Construct a new Debouncer object
+         *
+         * @param timer 定时器
+         * @param delay 静默时间（毫秒）
+         * @param cb 回调函数，在定时器线程中执行
+         */
+        Debouncer(Timer<T, Layout, Overflow> &timer, Tick_t delay, const Callback &cb)
+            : timer_(timer), delay_(delay), id_(timer.CreateTimer(T(kIdleDeadline, cb))) {}
+
+        ~Debouncer() { timer_.Cancel(id_); }
+
+        Debouncer(const Debouncer &) = delete;
+        Debouncer &operator=(const Debouncer &) = delete;
+
+        // 触发一次，重新开始计时
+        void Trigger() { timer_.Reschedule(id_, Now() + delay_); }
+
+        // 是否有尚未执行的回调
+        bool Pending() const { return id_.Node()->Deadline() != kIdleDeadline; }
+
+    private:
+        Timer<T, Layout, Overflow> &timer_; // 定时器
+        Tick_t delay_;                      // 静默时间
+        TimerId id_;                        // 定时任务节点
+    };
+} // namespace CTimer
+
+#endif /* _DEBOUNCER_H_ */
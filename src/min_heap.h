@@ -4,6 +4,7 @@
 #include <vector>
 #include <mutex>
 #include <functional>
+#include <utility>
 #include "spinlock.h"
 
 namespace CTimer {
@@ -28,6 +29,12 @@ namespace CTimer {
             siftUp(heap_.size() - 1);
         }
 
+        void push(T &&val) {
+            std::lock_guard<SpinLock> lock(mutex_);
+            heap_.push_back(std::move(val));
+            siftUp(heap_.size() - 1);
+        }
+
         // 获取堆顶元素
         T top() const {
             std::lock_guard<SpinLock> lock(mutex_);
@@ -48,6 +55,12 @@ namespace CTimer {
             return heap_.size();
         }
 
+        // 获取已分配的容量
+        size_t capacity() const {
+            std::lock_guard<SpinLock> lock(mutex_);
+            return heap_.capacity();
+        }
+
         // 判断堆是否为空
         bool empty() const {
             std::lock_guard<SpinLock> lock(mutex_);
@@ -62,6 +75,18 @@ namespace CTimer {
             }
         }
 
+        // 按存储顺序将所有元素移交给 f 并清空，保留已分配的容量
+        template <typename F>
+        size_t drain(F &&f) {
+            std::lock_guard<SpinLock> lock(mutex_);
+            size_t count = heap_.size();
+            for (auto &elem : heap_) {
+                f(std::move(elem));
+            }
+            heap_.clear();
+            return count;
+        }
+
         // 删除
         void remove(const T &elem) {
             std::lock_guard<SpinLock> lock(mutex_);
@@ -0,0 +1,721 @@
+#ifndef _SHM_TIMER_H_
+#define _SHM_TIMER_H_
+
+#ifdef __linux__
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "timer.h"
+
+/**
+ * @brief 多进程共享定时服务
+ *
+ * 服务进程持有唯一的定时器，其他进程通过 POSIX 共享内存中的单生产者单消费者环形队列
+ * 提交添加、取消请求并接收到期通知。客户端通过 unix socket 连接服务，服务分配一个通道，
+ * 并通过 SCM_RIGHTS 传递服务端和该通道的 eventfd。
+ *
+ * 提交请求只写共享内存，服务线程阻塞等待时才写 eventfd 唤醒；服务线程处理完请求后
+ * 继续轮询 kShmLinger 微秒，连续提交的请求不产生系统调用。接收到期通知同理
+ */
+
+namespace CTimer {
+
+    // 共享内存格式标识与版本
+    const uint32_t kShmMagic = 0x43544d52;
+    const uint32_t kShmVersion = 1;
+    // 最大客户端数量
+    const uint32_t kShmMaxClients = 32;
+    // 每个通道请求队列和到期队列的容量
+    const size_t kShmRingSize = 1024;
+    // 服务线程处理完请求后继续轮询的时长（微秒）
+    const Tick_t kShmLinger = 2000;
+    // 服务线程轮询间隔（微秒）
+    const Tick_t kShmPollInterval = 100;
+    // 没有空闲通道
+    const uint32_t kShmNoSlot = ~uint32_t(0);
+
+    /**
+     * @brief 共享内存中的单生产者单消费者环形队列
+     *
+     * 只使用无锁原子变量，可以在多个进程之间共享
+     */
+    template <typename T, size_t N>
+    class ShmRing {
+        static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory requires lock-free atomics");
+
+    public:
+        ShmRing() : head_(0), tail_(0) {}
+
+        // 清空队列，只能在生产者和消费者都不访问时调用
+        void Reset() {
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        // 生产者写入，队列已满时返回 false
+        bool Push(const T &item) {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == N) {
+                return false;
+            }
+            items_[tail & (N - 1)] = item;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 消费者读取，队列为空时返回 false
+        bool Pop(T &item) {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            item = items_[head & (N - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+    private:
+        alignas(64) std::atomic<uint64_t> head_; // 消费者位置
+        alignas(64) std::atomic<uint64_t> tail_; // 生产者位置
+        alignas(64) T items_[N];
+    };
+
+    // 请求类型
+    enum ShmTimerOp : uint32_t {
+        kShmAddTimer,
+        kShmCancelTimer,
+    };
+
+    // 客户端提交的请求
+    struct ShmTimerRequest {
+        uint64_t id;        // 客户端分配的任务标识
+        Tick_t expire_time; // 到期时间（毫秒）
+        Tick_t interval;    // 执行间隔（毫秒），0 表示一次性任务
+        ShmTimerOp op;      // 请求类型
+    };
+
+    // 到期通知
+    struct ShmTimerExpiry {
+        uint64_t id;     // 任务标识
+        Tick_t fireTime; // 执行时间（微秒）
+    };
+
+    // 一个客户端使用的通道
+    struct ShmTimerChannel {
+        std::atomic<uint32_t> clientWaiting;                       // 客户端是否阻塞等待到期通知
+        ShmRing<ShmTimerRequest, kShmRingSize> requests;           // 请求队列，客户端写入
+        ShmRing<ShmTimerExpiry, kShmRingSize> expirations;         // 到期队列，服务端写入
+    };
+
+    // 共享内存布局
+    struct ShmTimerRegion {
+        uint32_t magic;                                 // 格式标识
+        uint32_t version;                               // 格式版本
+        std::atomic<uint32_t> serviceWaiting;           // 服务线程是否阻塞等待
+        ShmTimerChannel channels[kShmMaxClients];       // 客户端通道
+    };
+
+    namespace detail {
+        inline std::string ShmName(const std::string &name) { return "/ctimer." + name; }
+
+        // 服务使用抽象命名空间的 unix socket，不在文件系统中留下文件
+        inline socklen_t ShmSocketAddress(const std::string &name, sockaddr_un &addr) {
+            std::string path = "ctimer." + name;
+            memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            size_t len = std::min(path.size(), sizeof(addr.sun_path) - 1);
+            memcpy(addr.sun_path + 1, path.data(), len);
+            return offsetof(sockaddr_un, sun_path) + 1 + len;
+        }
+
+        // 发送通道号和文件描述符
+        inline bool SendSlot(int sock, uint32_t slot, const int *fds, int count) {
+            struct iovec iov = {&slot, sizeof(slot)};
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)];
+            if (count > 0) {
+                memset(control, 0, sizeof(control));
+                msg.msg_control = control;
+                msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_RIGHTS;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+                memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+            }
+            return sendmsg(sock, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(slot));
+        }
+
+        // 接收通道号和两个文件描述符
+        inline bool RecvSlot(int sock, uint32_t &slot, int *fds) {
+            struct iovec iov = {&slot, sizeof(slot)};
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)];
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (recvmsg(sock, &msg, MSG_CMSG_CLOEXEC) != static_cast<ssize_t>(sizeof(slot)) || slot == kShmNoSlot) {
+                return false;
+            }
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+                cmsg->cmsg_len != CMSG_LEN(sizeof(int) * 2)) {
+                return false;
+            }
+            memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * 2);
+            return true;
+        }
+
+        // 写入共享队列后检查对端是否在等待，需要时通过 eventfd 唤醒
+        inline void WakeIfWaiting(const std::atomic<uint32_t> &waiting, int fd) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting.load(std::memory_order_relaxed)) {
+                eventfd_write(fd, 1);
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief 共享定时服务，运行在持有定时器的进程中
+     */
+    class ShmTimerService {
+    public:
+        /**
+         * @brief Construct a new Shm Timer Service object
+         *
+         * @param name 服务名，决定共享内存和 unix socket 的名称
+         * @param resolution 定时器时间粒度
+         */
+        explicit ShmTimerService(const std::string &name, std::chrono::microseconds resolution = std::chrono::milliseconds(1))
+            : name_(name), timer_(resolution), region_(nullptr), created_(false), listenFd_(-1), wakeFd_(-1), quit_(false) {
+            for (uint32_t i = 0; i < kShmMaxClients; i++) {
+                clients_.emplace_back(new Client());
+            }
+        }
+
+        ~ShmTimerService() { Stop(); }
+
+        ShmTimerService(const ShmTimerService &) = delete;
+        ShmTimerService &operator=(const ShmTimerService &) = delete;
+
+        // 创建共享内存和 unix socket，启动定时器和服务线程
+        bool Start();
+
+        // 停止服务，断开所有客户端并删除共享内存
+        void Stop();
+
+        // 已连接的客户端数量
+        size_t Clients() const;
+
+    private:
+        // 服务端保存的客户端状态
+        struct Client {
+            int sock = -1;                                  // 连接
+            int eventFd = -1;                               // 唤醒客户端的 eventfd
+            bool active = false;                            // 是否已连接
+            uint64_t generation = 0;                        // 通道复用代数，旧连接的到期回调直接丢弃
+            std::unordered_map<uint64_t, TimerId> timers;   // 客户端任务标识到定时任务的映射
+            std::deque<ShmTimerExpiry> backlog;             // 到期队列已满时暂存的通知
+            std::unique_ptr<TimerGroup> group;              // 客户端的全部任务，断开时批量取消
+            std::mutex mutex;
+        };
+
+        // 服务线程函数
+        void ServiceThreadFunc();
+
+        // 处理全部通道的请求，返回处理的数量
+        size_t DrainRequests();
+
+        // 处理一个请求
+        void HandleRequest(uint32_t slot, const ShmTimerRequest &request);
+
+        // 在定时器线程中投递到期通知
+        void Deliver(uint32_t slot, uint64_t generation, uint64_t id, bool periodic);
+
+        // 将暂存的通知写入到期队列，返回是否仍有暂存
+        bool FlushBacklogs();
+
+        // 接受新连接并分配通道
+        void Accept();
+
+        // 断开客户端，取消其全部任务
+        void Disconnect(uint32_t slot);
+
+        std::string name_;                            // 服务名
+        Timer<TimerTask> timer_;                      // 唯一的定时器
+        ShmTimerRegion *region_;                      // 共享内存
+        bool created_;                                // 共享内存由本实例创建
+        int listenFd_;                                // 监听 socket
+        int wakeFd_;                                  // 唤醒服务线程的 eventfd
+        std::vector<std::unique_ptr<Client>> clients_; // 按通道号索引的客户端
+        std::unique_ptr<std::thread> thread_;         // 服务线程
+        std::atomic<bool> quit_;                      // 退出标记
+    };
+
+    inline bool ShmTimerService::Start() {
+        // 先绑定 socket 作为单实例锁，同名服务已在运行时直接失败，不触碰它的共享内存
+        sockaddr_un sa;
+        socklen_t len = detail::ShmSocketAddress(name_, sa);
+        listenFd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (listenFd_ < 0 || wakeFd_ < 0 || bind(listenFd_, reinterpret_cast<sockaddr *>(&sa), len) != 0 ||
+            listen(listenFd_, kShmMaxClients) != 0) {
+            Stop();
+            return false;
+        }
+
+        // 持有锁时已存在的同名共享内存只可能是异常退出的服务遗留的
+        std::string shmName = detail::ShmName(name_);
+        int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0 && errno == EEXIST) {
+            shm_unlink(shmName.c_str());
+            fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+        }
+        if (fd < 0) {
+            Stop();
+            return false;
+        }
+        created_ = true;
+        void *addr = MAP_FAILED;
+        if (ftruncate(fd, sizeof(ShmTimerRegion)) == 0) {
+            addr = mmap(nullptr, sizeof(ShmTimerRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (addr == MAP_FAILED) {
+            Stop();
+            return false;
+        }
+        region_ = new (addr) ShmTimerRegion();
+        region_->version = kShmVersion;
+        region_->serviceWaiting.store(0, std::memory_order_relaxed);
+        // 最后写入格式标识，客户端看到标识时共享内存已经初始化完成
+        std::atomic_thread_fence(std::memory_order_release);
+        region_->magic = kShmMagic;
+
+        quit_ = false;
+        timer_.Start();
+        thread_.reset(new std::thread(&ShmTimerService::ServiceThreadFunc, this));
+        return true;
+    }
+
+    inline void ShmTimerService::Stop() {
+        quit_ = true;
+        if (thread_ && thread_->joinable()) {
+            eventfd_write(wakeFd_, 1);
+            thread_->join();
+        }
+        thread_.reset();
+        for (uint32_t i = 0; i < kShmMaxClients; i++) {
+            Disconnect(i);
+        }
+        timer_.Stop();
+        if (listenFd_ >= 0) {
+            close(listenFd_);
+            listenFd_ = -1;
+        }
+        if (wakeFd_ >= 0) {
+            close(wakeFd_);
+            wakeFd_ = -1;
+        }
+        if (region_) {
+            region_->~ShmTimerRegion();
+            munmap(region_, sizeof(ShmTimerRegion));
+            region_ = nullptr;
+        }
+        // 只删除本实例创建的共享内存
+        if (created_) {
+            shm_unlink(detail::ShmName(name_).c_str());
+            created_ = false;
+        }
+    }
+
+    inline size_t ShmTimerService::Clients() const {
+        size_t count = 0;
+        for (auto &client : clients_) {
+            std::lock_guard<std::mutex> lock(client->mutex);
+            count += client->active;
+        }
+        return count;
+    }
+
+    inline void ShmTimerService::ServiceThreadFunc() {
+        std::vector<pollfd> fds;
+        std::vector<uint32_t> slots;
+        Tick_t lastBusy = 0;
+        while (!quit_) {
+            bool busy = DrainRequests() > 0;
+            bool backlog = FlushBacklogs();
+            Tick_t now = NowMicro();
+            if (busy) {
+                lastBusy = now;
+            }
+
+            // 有请求时只检查连接，处理完请求后短暂轮询，之后阻塞等待客户端唤醒
+            struct timespec timeout = {0, 0};
+            struct timespec *ptimeout = &timeout;
+            bool block = !busy && !backlog && now - lastBusy >= kShmLinger;
+            if (block) {
+                region_->serviceWaiting.store(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (DrainRequests() > 0) {
+                    region_->serviceWaiting.store(0, std::memory_order_relaxed);
+                    lastBusy = NowMicro();
+                    continue;
+                }
+                ptimeout = nullptr;
+            } else if (!busy) {
+                timeout.tv_nsec = kShmPollInterval * 1000;
+            }
+
+            fds.clear();
+            slots.clear();
+            fds.push_back({wakeFd_, POLLIN, 0});
+            fds.push_back({listenFd_, POLLIN, 0});
+            for (uint32_t i = 0; i < kShmMaxClients; i++) {
+                if (clients_[i]->sock >= 0) {
+                    fds.push_back({clients_[i]->sock, POLLIN, 0});
+                    slots.push_back(i);
+                }
+            }
+            int ready = ppoll(fds.data(), fds.size(), ptimeout, nullptr);
+            region_->serviceWaiting.store(0, std::memory_order_relaxed);
+            if (ready <= 0) {
+                continue;
+            }
+            if (fds[0].revents & POLLIN) {
+                eventfd_t value;
+                eventfd_read(wakeFd_, &value);
+                lastBusy = NowMicro();
+            }
+            if (fds[1].revents & POLLIN) {
+                Accept();
+            }
+            // 客户端只在断开时产生可读事件
+            for (size_t i = 0; i < slots.size(); i++) {
+                if (fds[i + 2].revents) {
+                    Disconnect(slots[i]);
+                }
+            }
+        }
+    }
+
+    inline size_t ShmTimerService::DrainRequests() {
+        size_t count = 0;
+        for (uint32_t i = 0; i < kShmMaxClients; i++) {
+            if (clients_[i]->sock < 0) {
+                continue;
+            }
+            ShmTimerRequest request;
+            while (region_->channels[i].requests.Pop(request)) {
+                HandleRequest(i, request);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    inline void ShmTimerService::HandleRequest(uint32_t slot, const ShmTimerRequest &request) {
+        Client &client = *clients_[slot];
+        std::lock_guard<std::mutex> lock(client.mutex);
+        if (request.op == kShmCancelTimer) {
+            auto it = client.timers.find(request.id);
+            if (it != client.timers.end()) {
+                timer_.Cancel(it->second);
+                client.timers.erase(it);
+            }
+            return;
+        }
+        // 超出范围的到期时间和周期无法换算为 tick，直接丢弃
+        if (request.expire_time > kMaxExpireTime || request.interval > kMaxExpireTime) {
+            return;
+        }
+        uint64_t generation = client.generation, id = request.id;
+        bool periodic = request.interval > 0;
+        client.timers[id] = timer_.AddTimer(TimerTask(request.interval, request.expire_time, [this, slot, generation, id, periodic]() {
+                                                Deliver(slot, generation, id, periodic);
+                                            }),
+                                            *client.group);
+    }
+
+    inline void ShmTimerService::Deliver(uint32_t slot, uint64_t generation, uint64_t id, bool periodic) {
+        Client &client = *clients_[slot];
+        std::lock_guard<std::mutex> lock(client.mutex);
+        if (!client.active || client.generation != generation) {
+            return;
+        }
+        if (!periodic) {
+            client.timers.erase(id);
+        }
+        ShmTimerChannel &channel = region_->channels[slot];
+        ShmTimerExpiry expiry = {id, NowMicro()};
+        // 已有暂存时继续暂存，保证通知按执行顺序到达
+        if (!client.backlog.empty() || !channel.expirations.Push(expiry)) {
+            client.backlog.push_back(expiry);
+            return;
+        }
+        detail::WakeIfWaiting(channel.clientWaiting, client.eventFd);
+    }
+
+    inline bool ShmTimerService::FlushBacklogs() {
+        bool pending = false;
+        for (uint32_t i = 0; i < kShmMaxClients; i++) {
+            Client &client = *clients_[i];
+            std::lock_guard<std::mutex> lock(client.mutex);
+            if (client.backlog.empty()) {
+                continue;
+            }
+            ShmTimerChannel &channel = region_->channels[i];
+            size_t pushed = 0;
+            while (!client.backlog.empty() && channel.expirations.Push(client.backlog.front())) {
+                client.backlog.pop_front();
+                pushed++;
+            }
+            if (pushed > 0) {
+                detail::WakeIfWaiting(channel.clientWaiting, client.eventFd);
+            }
+            pending = pending || !client.backlog.empty();
+        }
+        return pending;
+    }
+
+    inline void ShmTimerService::Accept() {
+        int sock;
+        while ((sock = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC)) >= 0) {
+            uint32_t slot = kShmNoSlot;
+            for (uint32_t i = 0; i < kShmMaxClients && slot == kShmNoSlot; i++) {
+                if (clients_[i]->sock < 0) {
+                    slot = i;
+                }
+            }
+            int eventFd = slot == kShmNoSlot ? -1 : eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (eventFd < 0) {
+                detail::SendSlot(sock, kShmNoSlot, nullptr, 0);
+                close(sock);
+                continue;
+            }
+
+            Client &client = *clients_[slot];
+            {
+                std::lock_guard<std::mutex> lock(client.mutex);
+                ShmTimerChannel &channel = region_->channels[slot];
+                channel.requests.Reset();
+                channel.expirations.Reset();
+                channel.clientWaiting.store(0, std::memory_order_relaxed);
+                client.sock = sock;
+                client.eventFd = eventFd;
+                client.active = true;
+                client.generation++;
+                client.group.reset(new TimerGroup());
+            }
+            int fds[2] = {wakeFd_, eventFd};
+            if (!detail::SendSlot(sock, slot, fds, 2)) {
+                Disconnect(slot);
+            }
+        }
+    }
+
+    inline void ShmTimerService::Disconnect(uint32_t slot) {
+        Client &client = *clients_[slot];
+        std::unique_ptr<TimerGroup> group;
+        {
+            std::lock_guard<std::mutex> lock(client.mutex);
+            if (client.sock < 0) {
+                return;
+            }
+            client.active = false;
+            client.generation++;
+            client.timers.clear();
+            client.backlog.clear();
+            close(client.sock);
+            close(client.eventFd);
+            client.sock = client.eventFd = -1;
+            group = std::move(client.group);
+        }
+        // 析构分组时取消该客户端的全部任务
+        group.reset();
+    }
+
+    /**
+     * @brief 共享定时服务的客户端
+     *
+     * 提交请求和读取到期通知都不需要系统调用，同一个客户端对象只能在一个线程中提交请求和读取通知。
+     * 取消请求异步处理，取消前已经到期的任务仍会收到到期通知
+     */
+    class ShmTimerClient {
+    public:
+        explicit ShmTimerClient(const std::string &name)
+            : name_(name), region_(nullptr), channel_(nullptr), sock_(-1), serviceFd_(-1), eventFd_(-1), nextId_(0) {}
+
+        ~ShmTimerClient() { Close(); }
+
+        ShmTimerClient(const ShmTimerClient &) = delete;
+        ShmTimerClient &operator=(const ShmTimerClient &) = delete;
+
+        // 连接服务并映射共享内存
+        bool Connect();
+
+        // 断开连接，服务端取消该客户端的全部任务
+        void Close();
+
+        /**
+         * @brief 添加定时任务
+         *
+         * @param expire_time 到期时间（毫秒）
+         * @param interval 执行间隔（毫秒），0 表示一次性任务
+         * @return 任务标识，请求队列已满时返回 0
+         */
+        uint64_t AddTimer(Tick_t expire_time, Tick_t interval = 0);
+
+        // 取消定时任务，请求队列已满时返回 false
+        bool Cancel(uint64_t id);
+
+        // 读取全部到期通知，逐个交给 visit(const ShmTimerExpiry &)，返回读取的数量
+        template <typename Visitor>
+        size_t Poll(Visitor &&visit);
+
+        // 等待到期通知，timeout 为毫秒，-1 表示一直等待，返回是否有通知可读
+        bool Wait(int timeout);
+
+        // 到期时会被写入的 eventfd，可以加入调用方自己的 epoll，只在 Wait 期间被写入
+        int EventFd() const { return eventFd_; }
+
+    private:
+        // 写入请求队列，服务线程阻塞时唤醒
+        bool Submit(const ShmTimerRequest &request);
+
+        std::string name_;          // 服务名
+        ShmTimerRegion *region_;    // 共享内存
+        ShmTimerChannel *channel_;  // 分配到的通道
+        int sock_;                  // 与服务的连接
+        int serviceFd_;             // 唤醒服务线程的 eventfd
+        int eventFd_;               // 服务唤醒本客户端的 eventfd
+        uint64_t nextId_;           // 下一个任务标识
+    };
+
+    inline bool ShmTimerClient::Connect() {
+        sockaddr_un sa;
+        socklen_t len = detail::ShmSocketAddress(name_, sa);
+        sock_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        uint32_t slot;
+        int fds[2];
+        if (sock_ < 0 || connect(sock_, reinterpret_cast<sockaddr *>(&sa), len) != 0 || !detail::RecvSlot(sock_, slot, fds)) {
+            Close();
+            return false;
+        }
+        serviceFd_ = fds[0];
+        eventFd_ = fds[1];
+
+        int fd = shm_open(detail::ShmName(name_).c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0) {
+            Close();
+            return false;
+        }
+        void *addr = mmap(nullptr, sizeof(ShmTimerRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        region_ = static_cast<ShmTimerRegion *>(addr);
+        if (region_->magic != kShmMagic || region_->version != kShmVersion || slot >= kShmMaxClients) {
+            Close();
+            return false;
+        }
+        channel_ = &region_->channels[slot];
+        return true;
+    }
+
+    inline void ShmTimerClient::Close() {
+        if (region_) {
+            munmap(region_, sizeof(ShmTimerRegion));
+            region_ = nullptr;
+            channel_ = nullptr;
+        }
+        for (int *fd : {&sock_, &serviceFd_, &eventFd_}) {
+            if (*fd >= 0) {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    inline bool ShmTimerClient::Submit(const ShmTimerRequest &request) {
+        if (!channel_ || !channel_->requests.Push(request)) {
+            return false;
+        }
+        detail::WakeIfWaiting(region_->serviceWaiting, serviceFd_);
+        return true;
+    }
+
+    inline uint64_t ShmTimerClient::AddTimer(Tick_t expire_time, Tick_t interval) {
+        uint64_t id = ++nextId_;
+        return Submit({id, expire_time, interval, kShmAddTimer}) ? id : 0;
+    }
+
+    inline bool ShmTimerClient::Cancel(uint64_t id) {
+        return Submit({id, 0, 0, kShmCancelTimer});
+    }
+
+    template <typename Visitor>
+    size_t ShmTimerClient::Poll(Visitor &&visit) {
+        size_t count = 0;
+        ShmTimerExpiry expiry;
+        while (channel_ && channel_->expirations.Pop(expiry)) {
+            visit(expiry);
+            count++;
+        }
+        return count;
+    }
+
+    inline bool ShmTimerClient::Wait(int timeout) {
+        if (!channel_) {
+            return false;
+        }
+        if (!channel_->expirations.Empty()) {
+            return true;
+        }
+        // 先发布等待标记再检查队列，服务端写入后看到标记就会唤醒
+        channel_->clientWaiting.store(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (channel_->expirations.Empty()) {
+            pollfd fd = {eventFd_, POLLIN, 0};
+            if (poll(&fd, 1, timeout) > 0) {
+                eventfd_t value;
+                eventfd_read(eventFd_, &value);
+            }
+        }
+        channel_->clientWaiting.store(0, std::memory_order_relaxed);
+        return !channel_->expirations.Empty();
+    }
+} // namespace CTimer
+
+#endif // __linux__
+
+#endif /* _SHM_TIMER_H_ */
@@ -0,0 +1,61 @@
+#ifndef _THROTTLER_H_
+#define _THROTTLER_H_
+
+#include <atomic>
+#include <memory>
+
+#include "timer.h"
+
+namespace CTimer {
+
+    /**
+     * @brief 节流
+     *
+     * 每 interval 毫秒最多执行一次回调，窗口内的触发合并到窗口结束时执行。
+     * 只持有一个定时任务节点，窗口内的触发只读写一个原子标记，不访问时间轮
+     */
+    template <typename T, typename Layout = RuntimeWheelLayout, typename Overflow = TimerHeap<TimerEntry<T>>>
+    class Throttler {
+    public:
+        /**
+         * @brief Construct a new Throttler object
+         *
+         * @param timer 定时器
+         * @param interval 最小执行间隔（毫秒）
+         * @param cb 回调函数，在定时器线程中执行
+         */
+        Throttler(Timer<T, Layout, Overflow> &timer, Tick_t interval, const Callback &cb)
+            : timer_(timer), interval_(interval), armed_(std::make_shared<std::atomic<bool>>(false)) {
+            auto armed = armed_;
+            id_ = timer.CreateTimer(T(kIdleDeadline, [armed, cb]() {
+                // 先清除标记，执行回调期间的触发会开启下一个窗口
+                armed->store(false, std::memory_order_release);
+                cb();
+            }));
+        }
+
+        ~Throttler() { timer_.Cancel(id_); }
+
+        Throttler(const Throttler &) = delete;
+        Throttler &operator=(const Throttler &) = delete;
+
+        // 触发一次，窗口未开启时开启新窗口
+        void Trigger() {
+            if (armed_->load(std::memory_order_acquire) || armed_->exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            timer_.Reschedule(id_, Now() + interval_);
+        }
+
+        // 是否有尚未执行的回调
+        bool Pending() const { return armed_->load(std::memory_order_acquire); }
+
+    private:
+        Timer<T, Layout, Overflow> &timer_;        // 定时器
+        Tick_t interval_;                          // 最小执行间隔
+        std::shared_ptr<std::atomic<bool>> armed_; // 窗口是否已开启
+        TimerId id_;                               // 定时任务节点
+    };
+} // namespace CTimer
+
+#endif /* _THROTTLER_H_ */
@@ -5,42 +5,75 @@
 #include <memory>
 #include <atomic>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <utility>
 #include <condition_variable>
+#include <cerrno>
+#include <ctime>
+
+#ifndef TIMER_HEAP_IMPLEMENTATION
+#define TIMER_HEAP_IMPLEMENTATION
+#endif
 
 #include "timer_task.h"
+#include "timer_entry.h"
+#include "timer_group.h"
 #include "timer_wheel.h"
 #include "timer_heap.h"
+#include "timer_skiplist.h"
+#include "wheel_layout.h"
+#include "timer_stats.h"
 
 namespace CTimer {
-    // 定时器类
-    template <typename T>
+
+    // 精确模式下距离唤醒时间不足该值（加上自旋时长）时不再等待条件变量，改为绝对时间睡眠（微秒）
+    const Tick_t kPrecisionWindow = 1000;
+    // 精确模式自旋时长的初始值和范围（微秒）
+    const Tick_t kDefaultSpin = 50;
+    const Tick_t kMinSpin = 5;
+    const Tick_t kMaxSpin = 500;
+
+    // 支持的最大到期时间（毫秒，约 2248 年），更晚的任务换算为 kIdleDeadline，永不到期
+    const Tick_t kMaxExpireTime = Tick_t(1) << 43;
+
+    // 任务数超过该值时从有序小数组切换到最小堆，降到四分之一时切换回来
+    const size_t kSmallTimers = 16;
+    // 任务数超过该值时从最小堆切换到时间轮，降到四分之一时切换回来
+    const size_t kHeapTimers = 4096;
+    // 已取消的节点不少于该值且达到任务项数量一半时，定时器线程清理存储中的失效任务项
+    const size_t kPurgeCancelled = 64;
+
+    /**
+     * @brief 定时器类
+     *
+     * Layout 为时间轮布局，默认运行期配置，也可以使用 WheelLayout<8, 6, 6, 6, 6> 等编译期布局。
+     * 任务较少时使用有序小数组，中等数量时使用最小堆，数量较多时使用多层时间轮，按任务数自动切换。
+     * Overflow 为最小堆和时间轮溢出任务的存储，默认 TimerHeap，长周期任务较多且多线程插入时可使用 TimerSkipList
+     */
+    template <typename T, typename Layout = RuntimeWheelLayout, typename Overflow = TimerHeap<TimerEntry<T>>>
     class Timer {
     public:
-        Timer(Tick_t tickInterval, const std::vector<int> &wheelSizes) : tickInterval_(tickInterval),
-                                                                         wheelSizes_(wheelSizes),
-                                                                         heap_(),
-                                                                         quit_(false) {
-            // 计算每个时间轮需要占据的二进制位数，并根据 wheelSizes 创建多个时间轮
-            int shiftBits = 0;
-            for (int i = 0; i < wheelSizes_.size(); i++) {
-                shifts_.push_back(shiftBits);
-                shiftBits += log2(wheelSizes_[i]);
-                wheels_.push_back(TimerWheel<T>(shiftBits, wheelSizes_[i]));
-            }
-        }
+        /**
+         * @brief Construct a new Timer object
+         *
+         * @param tickInterval 时间粒度（毫秒）
+         * @param layout 时间轮布局，运行期布局可直接传入每层时间轮占据的二进制位数
+         */
+        Timer(Tick_t tickInterval, const Layout &layout)
+            : Timer(std::chrono::milliseconds(tickInterval), layout) {}
 
-        Timer() : tickInterval_(kMinInterval),
-                  heap_(),
-                  quit_(false) {
-            wheelSizes_ = std::vector<int>({8, 6, 6, 6, 6});
-            // 计算每个时间轮需要占据的二进制位数，并根据 wheelSizes 创建多个时间轮
-            int shiftBits = 0;
-            for (int i = 0; i < wheelSizes_.size(); i++) {
-                shifts_.push_back(shiftBits);
-                shiftBits += log2(wheelSizes_[i]);
-                wheels_.push_back(TimerWheel<T>(shiftBits, wheelSizes_[i]));
-            }
-        }
+        /**
+         * @brief Construct a new Timer object
+         *
+         * @param resolution 时间粒度，取值范围 100us~1s
+         * @param layout 时间轮布局
+         */
+        Timer(std::chrono::microseconds resolution, const Layout &layout = Layout());
+
+        Timer() : Timer(std::chrono::milliseconds(kMinInterval)) {}
+
+        ~Timer() { Stop(); }
 
         // 启动定时器线程
         void Start();
@@ -49,99 +82,790 @@ namespace CTimer {
         void Stop();
 
         // 添加定时任务
-        void AddTimer(const T &task);
+        TimerId AddTimer(const T &task);
+
+        TimerId AddTimer(T &&task);
+
+        // 添加定时任务并加入分组，可通过 TimerGroup::CancelGroup 批量取消
+        TimerId AddTimer(const T &task, TimerGroup &group);
+
+        TimerId AddTimer(T &&task, TimerGroup &group);
+
+        /**
+         * @brief 在任务节点中原地构造定时任务，插入过程中只移动不复制
+         *
+         * @param delay 延迟时间（毫秒）
+         * @param args 到期时间之后的构造参数，即 T(Now() + delay, args...)
+         */
+        template <typename... Args>
+        TimerId EmplaceTimer(Tick_t delay, Args &&...args);
+
+        // 延迟 delay 毫秒执行一次 f，f 直接移入任务的回调函数
+        template <typename F>
+        TimerId Schedule(Tick_t delay, F &&f) { return EmplaceTimer(delay, Callback(std::forward<F>(f))); }
+
+        // 创建空闲的定时任务，不放入时间轮，通过 Reschedule 激活
+        TimerId CreateTimer(const T &task);
+
+        TimerId CreateTimer(T &&task);
+
+        /**
+         * @brief 重新设置定时任务的到期时间
+         *
+         * 延后到期时间只更新节点中的到期时间，不加锁也不移动任务项，
+         * 原槽位到期时再按新的到期时间重新放置；提前到期时间或重新激活已执行的任务时需要重新放置
+         *
+         * @param id 定时任务标识
+         * @param expire_time 新的到期时间（毫秒）
+         * @return 任务已取消或不属于当前定时器时返回 false
+         */
+        bool Reschedule(const TimerId &id, Tick_t expire_time);
+
+        // 取消定时任务，立即释放任务持有的资源，任务项由定时器线程批量清理
+        bool Cancel(const TimerId &id);
+
+        // 获取时间粒度（微秒）
+        Tick_t GetResolution() const { return resolution_; }
+
+        /**
+         * @brief 设置精确模式
+         *
+         * 精确模式下定时器线程在唤醒时间前 kPrecisionWindow 内不再等待条件变量，
+         * 先用 clock_nanosleep 绝对时间睡眠到唤醒时间前的自旋时长处，再自旋到唤醒时间。
+         * 自旋时长根据观测到的睡眠唤醒延迟自动校准。这段时间内添加的更早任务要等本次唤醒后才会处理
+         */
+        void SetPrecision(bool enable) {
+            precision_.store(enable, std::memory_order_relaxed);
+            cv_.notify_one();
+        }
+
+        bool Precision() const { return precision_.load(std::memory_order_relaxed); }
+
+        // 设置是否按任务数自动切换存储结构，关闭时固定使用时间轮
+        void SetAdaptive(bool enable);
+
+        /**
+         * @brief 设置每轮执行到期任务的预算，0 表示不限
+         *
+         * 一轮中执行的任务数达到 maxTimers 或耗时达到 maxMicros 后，剩余的到期任务留在积压队列中，
+         * 定时器线程回到锁内推进时间后再继续执行，积压的任务排在新到期的任务之前。
+         * 同一槽位大量任务同时到期时不会长时间停在一轮中
+         */
+        void SetWorkBudget(size_t maxTimers, Tick_t maxMicros) {
+            budgetTimers_.store(maxTimers, std::memory_order_relaxed);
+            budgetMicros_.store(maxMicros, std::memory_order_relaxed);
+        }
+
+        // 获取运行统计
+        TimerStats GetStats() const;
+
+        // 将到期时间（毫秒）换算为 tick，向上取整保证不提前触发，超出范围时不再换算以免溢出
+        Tick_t ToTick(Tick_t expire_time) const {
+            return expire_time > kMaxExpireTime ? kIdleDeadline : (expire_time * 1000 + resolution_ - 1) / resolution_;
+        }
 
     private:
         // 定时器线程函数
         void TimerThreadFunc();
 
-        Tick_t tickInterval_;                 // 时间粒度
-        std::vector<int> wheelSizes_;         // 每个时间轮的大小
-        std::vector<int> shifts_;             // 每个时间轮需要占据的二进制位数
-        std::vector<TimerWheel<T>> wheels_;   // 多层时间轮
-        TimerHeap<T> heap_;                   // 用于存储大于多层时间轮范围的定时器
-        std::unique_ptr<std::thread> thread_; // 当前线程
-        std::atomic<bool> quit_;              // 退出标记
+        // 获取当前 tick
+        Tick_t CurrentTick() const { return NowMicro() / resolution_; }
+
+        // 获取属于当前定时器的任务节点
+        std::shared_ptr<TimerNode<T>> GetNode(const TimerId &id) const;
+
+        // 放置新创建的任务节点
+        TimerId AddNode(const std::shared_ptr<TimerNode<T>> &node);
+
+        // 按到期 tick 将任务放入当前存储结构，时间轮中超出范围的放入最小堆
+        void InsertEntry(TimerEntry<T> &&entry);
+
+        // 按任务数选择存储结构，切换阈值带滞后避免来回迁移
+        void Adapt();
+
+        // 将全部任务项迁移到新的存储结构
+        void Migrate(TimerBackend backend);
+
+        // 取出全部任务项，丢弃失效的任务项后按 backend 重新放置
+        void Rebuild(TimerBackend backend);
+
+        // 已取消的节点较多时清理失效任务项，避免它们占用内存并影响存储结构的切换
+        void Purge();
+
+        // 处理有序小数组或最小堆中到期 tick 不晚于 now 的任务
+        void DrainDue(Tick_t now, std::vector<TimerEntry<T>> &expired);
+
+        // 按节点当前的到期时间重新放置任务项
+        void RefileEntry(TimerEntry<T> &entry);
+
+        // 处理到期的任务项，到期时间被延后的重新放置，否则加入待执行列表
+        void ExpireEntry(TimerEntry<T> &entry, std::vector<TimerEntry<T>> &expired);
+
+        // 推进一个 tick，并收集当前 tick 到期的任务
+        void Advance(std::vector<TimerEntry<T>> &expired);
+
+        // 获取下一个需要处理的 tick：最低层的非空槽位、高层非空槽位的降级时刻或最小堆任务进入时间轮范围的时刻
+        Tick_t NextEventTick() const;
+
+        // 获取最早的到期 tick，没有任务时返回 kIdleDeadline
+        Tick_t EarliestTick() const;
+
+        // 获取某层时间轮下一次处理的槽位，inclusive 表示当前槽位尚未处理
+        int FirstSlot(size_t level, bool &inclusive) const;
+
+        // 新任务早于定时器线程的唤醒时间时才唤醒线程，需在释放锁之后调用
+        void Notify(Tick_t tick) {
+            if (tick < wakeTick_.load(std::memory_order_acquire)) {
+                notifies_.fetch_add(1, std::memory_order_relaxed);
+                cv_.notify_one();
+            }
+        }
+
+        /**
+         * @brief 不加锁插入溢出存储后唤醒定时器线程
+         *
+         * 定时器线程发布唤醒 tick 后会再检查一次溢出存储，两边都用全序操作，至少一方能看到对方。
+         * 需要唤醒时先获取一次锁，确保定时器线程已经进入等待，通知不会丢失
+         */
+        void NotifyOverflow(Tick_t tick) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (tick < wakeTick_.load(std::memory_order_seq_cst)) {
+                { std::lock_guard<std::mutex> lock(mutex_); }
+                notifies_.fetch_add(1, std::memory_order_relaxed);
+                cv_.notify_one();
+            }
+        }
+
+        // 当前时间轮范围的末尾 tick，时间轮覆盖全部 tick 时为 kIdleDeadline
+        Tick_t Horizon() const {
+            return layout_.TotalBits() < 64 ? curTick_ + (Tick_t(1) << layout_.TotalBits()) - 1 : kIdleDeadline;
+        }
+
+        // 精确模式下睡眠并自旋到 wakeup（微秒），调用时不持有锁
+        void PreciseSleep(Tick_t wakeup);
+
+        // 根据睡眠唤醒延迟（微秒）校准自旋时长
+        void CalibrateSpin(Tick_t latency);
+
+        Tick_t resolution_;                                      // 时间粒度（微秒）
+        Layout layout_;                                          // 时间轮布局
+        Tick_t curTick_;                                         // 下一个待处理的 tick
+        typename Layout::template Wheels<TimerEntry<T>> wheels_; // 多层时间轮
+        Overflow heap_;                                          // 最小堆存储结构，时间轮存储结构下存放超出范围的定时器
+        std::vector<TimerEntry<T>> small_;                       // 有序小数组存储结构
+        std::vector<TimerEntry<T>> due_;                         // 处理有序小数组和迁移时复用的缓冲区
+        TimerBackend backend_;                                   // 当前存储结构
+        bool adaptive_;                                          // 是否自动切换存储结构
+        std::atomic<size_t> population_;                         // 存储中的任务项数量
+        uint64_t migrations_;                                    // 切换存储结构的次数
+        std::shared_ptr<std::atomic<size_t>> cancelled_;         // 上次清理后取消的节点数，由节点取消时递增
+        std::unique_ptr<std::thread> thread_;                    // 当前线程
+        std::atomic<bool> quit_;                                 // 退出标记
+        std::atomic<Tick_t> wakeTick_;                           // 定时器线程睡眠时的唤醒 tick，运行时为 0
+        std::atomic<Tick_t> horizon_;                            // 时间轮范围的末尾 tick，更晚的新任务不加锁直接放入溢出存储
+        std::atomic<bool> precision_;                            // 精确模式
+        std::atomic<Tick_t> spinThreshold_;                      // 精确模式自旋时长（微秒）
+        std::atomic<Tick_t> sleepLatency_;                       // 睡眠唤醒延迟的平滑值（微秒）
+        std::atomic<Tick_t> maxSleepLatency_;                    // 最大睡眠唤醒延迟（微秒）
+        std::atomic<Tick_t> maxLateness_;                        // 精确模式醒来时的最大延迟（微秒）
+        std::atomic<uint64_t> wakeups_;                          // 唤醒次数
+        std::atomic<uint64_t> notifies_;                         // 添加任务时唤醒的次数
+        std::atomic<uint64_t> expired_;                          // 已执行的任务数
+        std::atomic<size_t> budgetTimers_;                       // 每轮最多执行的任务数，0 表示不限
+        std::atomic<Tick_t> budgetMicros_;                       // 每轮最长执行时间（微秒），0 表示不限
+        std::atomic<size_t> backlog_;                            // 积压的到期任务数
+        std::atomic<size_t> maxBacklog_;                         // 最大积压任务数
+        std::atomic<uint64_t> carryovers_;                       // 超出预算留到下一轮的任务数
+        std::atomic<Tick_t> maxCarryoverLateness_;               // 积压任务执行时晚于到期时间的最大值（微秒）
         std::condition_variable cv_;
         mutable std::mutex mutex_;
     };
 
-    template <typename T>
-    void Timer<T>::Start() {
+    template <typename T, typename Layout, typename Overflow>
+    Timer<T, Layout, Overflow>::Timer(std::chrono::microseconds resolution, const Layout &layout)
+        : resolution_(std::min<Tick_t>(std::max<Tick_t>(resolution.count(), kMinResolution), kMaxResolution)),
+          layout_(layout),
+          curTick_(CurrentTick()),
+          wheels_(layout_.template MakeWheels<TimerEntry<T>>()),
+          heap_(),
+          backend_(kSmallBackend),
+          adaptive_(true),
+          population_(0),
+          migrations_(0),
+          cancelled_(std::make_shared<std::atomic<size_t>>(0)),
+          quit_(false),
+          wakeTick_(0),
+          horizon_(Horizon()),
+          precision_(false),
+          spinThreshold_(kDefaultSpin),
+          sleepLatency_(0),
+          maxSleepLatency_(0),
+          maxLateness_(0),
+          wakeups_(0),
+          notifies_(0),
+          expired_(0),
+          budgetTimers_(0),
+          budgetMicros_(0),
+          backlog_(0),
+          maxBacklog_(0),
+          carryovers_(0),
+          maxCarryoverLateness_(0) {
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Start() {
         quit_ = false;
         thread_.reset(new std::thread(&Timer::TimerThreadFunc, this));
     }
 
-    template <typename T>
-    void Timer<T>::Stop() {
-        quit_ = true;
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
         cv_.notify_one();
         if (thread_ && thread_->joinable()) {
             thread_->join();
         }
     }
 
-    template <typename T>
-    void Timer<T>::AddTimer(const T &task) {
-        Tick_t expire_time = task.ExpireTime();
-        Tick_t now = Now();
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::AddTimer(const T &task) {
+        return AddNode(std::make_shared<TimerNode<T>>(task));
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::AddTimer(T &&task) {
+        return AddNode(std::make_shared<TimerNode<T>>(std::move(task)));
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::AddTimer(const T &task, TimerGroup &group) {
+        auto node = std::make_shared<TimerNode<T>>(task);
+        node->JoinGroup(group.List());
+        return AddNode(node);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::AddTimer(T &&task, TimerGroup &group) {
+        auto node = std::make_shared<TimerNode<T>>(std::move(task));
+        node->JoinGroup(group.List());
+        return AddNode(node);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    template <typename... Args>
+    TimerId Timer<T, Layout, Overflow>::EmplaceTimer(Tick_t delay, Args &&...args) {
+        return AddNode(std::make_shared<TimerNode<T>>(std::in_place, Now() + delay, std::forward<Args>(args)...));
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::CreateTimer(const T &task) {
+        auto node = std::make_shared<TimerNode<T>>(task);
+        node->SetOwner(this, cancelled_);
+        node->SetDeadline(kIdleDeadline);
+        return TimerId(node);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::CreateTimer(T &&task) {
+        auto node = std::make_shared<TimerNode<T>>(std::move(task));
+        node->SetOwner(this, cancelled_);
+        node->SetDeadline(kIdleDeadline);
+        return TimerId(node);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerId Timer<T, Layout, Overflow>::AddNode(const std::shared_ptr<TimerNode<T>> &node) {
+        node->SetOwner(this, cancelled_);
+        Tick_t tick = ToTick(node->Deadline());
+        // 超出时间轮范围的新任务不经过定时器锁，直接放入溢出存储，任何存储结构下都会检查溢出存储
+        if (tick > horizon_.load(std::memory_order_relaxed)) {
+            population_++;
+            heap_.AddTimer(TimerEntry<T>(tick, node, node->Seq()));
+            NotifyOverflow(tick);
+            return TimerId(node);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            InsertEntry(TimerEntry<T>(tick, node, node->Seq()));
+            Adapt();
+        }
+        Notify(tick);
+        return TimerId(node);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    std::shared_ptr<TimerNode<T>> Timer<T, Layout, Overflow>::GetNode(const TimerId &id) const {
+        if (!id || id.Node()->Owner() != this) {
+            return nullptr;
+        }
+        return std::static_pointer_cast<TimerNode<T>>(id.Node());
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    bool Timer<T, Layout, Overflow>::Reschedule(const TimerId &id, Tick_t expire_time) {
+        auto node = GetNode(id);
+        if (!node || node->Cancelled()) {
+            return false;
+        }
+        // 延后到期时间：任务项仍在不晚于新到期时间的槽位中，只需更新节点
+        Tick_t deadline = node->Deadline();
+        while (deadline != kIdleDeadline && expire_time >= deadline) {
+            if (node->CompareExchangeDeadline(deadline, expire_time)) {
+                return true;
+            }
+        }
+        // 提前到期时间或重新激活：旧任务项失效，按新的到期时间重新放置
+        Tick_t tick = ToTick(expire_time);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            node->SetDeadline(expire_time);
+            InsertEntry(TimerEntry<T>(tick, node, node->NextSeq()));
+            Adapt();
+        }
+        Notify(tick);
+        return true;
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    bool Timer<T, Layout, Overflow>::Cancel(const TimerId &id) {
+        auto node = GetNode(id);
+        return node && node->Cancel();
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::InsertEntry(TimerEntry<T> &&entry) {
+        // 已取消或已失效的任务项直接丢弃
+        if (!entry.Live()) {
+            return;
+        }
+        population_++;
+        Tick_t tick = entry.ExpireTime();
+        // 已经到期的任务放到当前 tick，在下一次处理时执行
+        if (tick < curTick_) {
+            tick = curTick_;
+            entry.SetExpireTime(tick);
+        }
+        if (backend_ == kSmallBackend) {
+            // 到期 tick 相同的任务按插入顺序排列
+            auto pos = std::upper_bound(small_.begin(), small_.end(), entry);
+            small_.insert(pos, std::move(entry));
+            return;
+        }
+        if (backend_ == kHeapBackend) {
+            heap_.AddTimer(std::move(entry));
+            return;
+        }
+        // 根据距离当前 tick 的间隔选择层级
+        size_t level = layout_.Level(tick - curTick_);
+        if (level < layout_.Levels()) {
+            wheels_[level].AddTimer(std::move(entry), tick);
+            return;
+        }
+        // 超过时间轮的范围，添加到最小堆中
+        heap_.AddTimer(std::move(entry));
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Advance(std::vector<TimerEntry<T>> &expired) {
+        // 将进入时间轮范围的任务从最小堆移入时间轮
+        if (layout_.TotalBits() < 64) {
+            Tick_t limit = Horizon();
+            Tick_t earliest = heap_.GetEarliestTime();
+            if (earliest != Tick_t(kInvalidTime) && earliest <= limit) {
+                heap_.DrainExpired(limit, [this](TimerEntry<T> &&entry) {
+                    population_--;
+                    RefileEntry(entry);
+                });
+            }
+        }
+
+        // 低层时间轮转完一圈时，将高层当前槽位的任务重新分配到低层
+        for (size_t i = 1; i < layout_.Levels(); i++) {
+            if ((curTick_ & layout_.LowMask(i)) != 0) {
+                break;
+            }
+            wheels_[i].DrainExpired(curTick_, [this](TimerEntry<T> &&entry) {
+                population_--;
+                RefileEntry(entry);
+            });
+        }
+
+        // 先推进 tick，处理到期任务时重新放置的任务项不会落回当前槽位
+        Tick_t tick = curTick_++;
+        wheels_[0].DrainExpired(tick, [this, &expired](TimerEntry<T> &&entry) {
+            population_--;
+            ExpireEntry(entry, expired);
+        });
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::DrainDue(Tick_t now, std::vector<TimerEntry<T>> &expired) {
+        curTick_ = std::max(curTick_, now + 1);
+        if (backend_ == kSmallBackend) {
+            // 先移出到期任务，处理时重新放置的任务项会插回有序数组
+            auto end = std::upper_bound(small_.begin(), small_.end(), now, [](Tick_t tick, const TimerEntry<T> &entry) {
+                return tick < entry.ExpireTime();
+            });
+            std::move(small_.begin(), end, std::back_inserter(due_));
+            small_.erase(small_.begin(), end);
+            population_ -= due_.size();
+            for (auto &entry : due_) {
+                ExpireEntry(entry, expired);
+            }
+            due_.clear();
+        }
+        // 有序小数组模式下溢出存储中也可能有不加锁插入的任务
+        heap_.DrainExpired(now, [this, &expired](TimerEntry<T> &&entry) {
+            population_--;
+            ExpireEntry(entry, expired);
+        });
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Adapt() {
+        if (!adaptive_) {
+            return;
+        }
+        TimerBackend backend = backend_;
+        if (backend_ == kSmallBackend && population_ > kSmallTimers) {
+            backend = population_ > kHeapTimers ? kWheelBackend : kHeapBackend;
+        } else if (backend_ == kHeapBackend && population_ > kHeapTimers) {
+            backend = kWheelBackend;
+        } else if (backend_ != kSmallBackend && population_ <= kSmallTimers / 4) {
+            backend = kSmallBackend;
+        } else if (backend_ == kWheelBackend && population_ < kHeapTimers / 4) {
+            backend = kHeapBackend;
+        }
+        Migrate(backend);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Migrate(TimerBackend backend) {
+        if (backend == backend_) {
+            return;
+        }
+        Rebuild(backend);
+        // 任务数降低后不再使用时间轮，释放各层的槽位数组
+        if (backend_ != kWheelBackend) {
+            for (auto &wheel : wheels_) {
+                wheel.Shrink();
+            }
+        }
+        migrations_++;
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Rebuild(TimerBackend backend) {
+        std::move(small_.begin(), small_.end(), std::back_inserter(due_));
+        std::vector<TimerEntry<T>>().swap(small_);
+        heap_.DrainExpired(kIdleDeadline, due_);
+        for (auto &wheel : wheels_) {
+            wheel.DrainAll([this](TimerEntry<T> &&entry) { due_.push_back(std::move(entry)); });
+        }
+        backend_ = backend;
+        // 迁移期间可能有不加锁插入溢出存储的任务，只扣除取出的任务项
+        population_ -= due_.size();
+        if (backend_ == kSmallBackend) {
+            small_.reserve(kSmallTimers + 1);
+        }
+        for (auto &entry : due_) {
+            InsertEntry(std::move(entry));
+        }
+        due_.clear();
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::Purge() {
+        // 计数包含空闲节点和已自然丢弃的任务项，只会多清理；每次清理的开销由至少一半任务项的取消均摊
+        size_t cancelled = cancelled_->load(std::memory_order_relaxed);
+        if (cancelled < kPurgeCancelled || cancelled * 2 < population_) {
+            return;
+        }
+        cancelled_->fetch_sub(cancelled, std::memory_order_relaxed);
+        Rebuild(backend_);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::SetAdaptive(bool enable) {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (expire_time <= 0) {
-            task.GetCallback();
-        }
-        // 将定时器按照时间粒度拆分成不同的层级
-        for (int i = 0; i < wheelSizes_.size(); i++) {
-            // 获取当前层级下的时间轮和对应槽位
-            TimerWheel<T> &curWheel = wheels_[i];
-            int slotIndex = (expire_time >> shifts_[i]) & curWheel.GetWheelMask();
-            // 如果到达最后一层，则将定时器添加到槽位中
-            if (i == wheelSizes_.size() - 1) {
-                curWheel.AddTimer(task);
-            } else {
-                // 否则将定时器拆分成更精细的粒度，并将其添加到下一层的相应槽位中
-                Tick_t interval = curWheel.GetSlots().size() << shifts_[i];
-                expire_time = (expire_time >> shifts_[i]) << shifts_[i] + wheels_[i].GetShiftBits();
-                T t(interval, expire_time, task.GetCallback());
-                wheels_[i + 1].AddTimer(t);
+        adaptive_ = enable;
+        if (enable) {
+            Adapt();
+        } else {
+            Migrate(kWheelBackend);
+        }
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::RefileEntry(TimerEntry<T> &entry) {
+        if (!entry.Live()) {
+            return;
+        }
+        entry.SetExpireTime(ToTick(entry.Node()->Deadline()));
+        InsertEntry(std::move(entry));
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::ExpireEntry(TimerEntry<T> &entry, std::vector<TimerEntry<T>> &expired) {
+        if (!entry.Live()) {
+            return;
+        }
+        auto &node = entry.Node();
+        Tick_t interval = node->Task().Interval();
+        Tick_t deadline = node->Deadline();
+        Tick_t next;
+        do {
+            // 到期时间已被延后，按新的到期时间重新放置
+            if (ToTick(deadline) >= curTick_) {
+                entry.SetExpireTime(ToTick(deadline));
+                InsertEntry(std::move(entry));
+                return;
             }
+            // 周期任务顺延一个周期，一次性任务置为空闲
+            next = interval > 0 ? deadline + interval : kIdleDeadline;
+        } while (!node->CompareExchangeDeadline(deadline, next));
+
+        if (next != kIdleDeadline) {
+            InsertEntry(TimerEntry<T>(ToTick(next), node, entry.Seq()));
         }
+        expired.push_back(std::move(entry));
+    }
 
-        // 超过时间轮的精度范围，添加到最小堆中
-        heap_.AddTimer(task);
-        cv_.notify_one();
+    template <typename T, typename Layout, typename Overflow>
+    int Timer<T, Layout, Overflow>::FirstSlot(size_t level, bool &inclusive) const {
+        // 高层当前槽位已经降级过，其中只剩下一圈之后的任务，除非低层刚好转完一圈
+        inclusive = (curTick_ & layout_.LowMask(level)) == 0;
+        Tick_t base = (curTick_ >> layout_.Shift(level)) + (inclusive ? 0 : 1);
+        return wheels_[level].NextOccupiedSlot(base & wheels_[level].GetWheelMask());
     }
 
-    template <typename T>
-    void Timer<T>::TimerThreadFunc() {
-        while (!quit_) {
-            Tick_t now = Now();
-            Tick_t earliest_time = std::min<Tick_t>(wheels_[0].GetEarliestTime(), heap_.GetEarliestTime());
-            if (earliest_time == kInvalidTime || earliest_time > now + wheelSizes_[0]) {
-                // 所有定时任务都超过时间轮的精度范围，等待下一个定时任务
-                std::unique_lock<std::mutex> lock(mutex_);
-                cv_.wait_for(lock, std::chrono::milliseconds(tickInterval_));
+    template <typename T, typename Layout, typename Overflow>
+    Tick_t Timer<T, Layout, Overflow>::NextEventTick() const {
+        Tick_t next = kIdleDeadline;
+        for (size_t i = 0; i < layout_.Levels(); i++) {
+            bool inclusive;
+            int slot = FirstSlot(i, inclusive);
+            if (slot < 0) {
                 continue;
             }
-            if (earliest_time < now + tickInterval_) {
-                // 最早的定时任务已经到期，直接执行
-                std::vector<T> expired_tasks;
-                {
-                    std::lock_guard<std::mutex> lock(mutex_);
-                    // expired_tasks =
+            // 非空槽位所在区间的起始 tick 即为该层下一次需要处理的 tick
+            int shift = layout_.Shift(i);
+            Tick_t base = (curTick_ >> shift) + (inclusive ? 0 : 1);
+            Tick_t block = base + ((slot - base) & wheels_[i].GetWheelMask());
+            if (block <= (kIdleDeadline >> shift)) {
+                next = std::min(next, block << shift);
+            }
+        }
+        if (layout_.TotalBits() < 64) {
+            Tick_t earliest = heap_.GetEarliestTime();
+            if (earliest != Tick_t(kInvalidTime)) {
+                Tick_t range = Tick_t(1) << layout_.TotalBits();
+                next = std::min(next, std::max(curTick_, earliest >= range ? earliest - range + 1 : 0));
+            }
+        }
+        return next;
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    Tick_t Timer<T, Layout, Overflow>::EarliestTick() const {
+        Tick_t earliest = kIdleDeadline;
+        if (backend_ == kSmallBackend && !small_.empty()) {
+            earliest = small_.front().ExpireTime();
+        }
+        for (size_t i = 0; backend_ == kWheelBackend && i < layout_.Levels(); i++) {
+            bool inclusive;
+            int slot = FirstSlot(i, inclusive);
+            if (slot >= 0) {
+                earliest = std::min(earliest, wheels_[i].GetSlotEarliestTime(slot));
+            }
+        }
+        Tick_t heapEarliest = heap_.GetEarliestTime();
+        if (heapEarliest != Tick_t(kInvalidTime)) {
+            earliest = std::min(earliest, heapEarliest);
+        }
+        return earliest;
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::PreciseSleep(Tick_t wakeup) {
+        Tick_t spin = spinThreshold_.load(std::memory_order_relaxed);
+        Tick_t target = wakeup - spin;
+        if (NowMicro() < target) {
+#ifdef __linux__
+            // system_clock 与 CLOCK_REALTIME 同源，按绝对时间睡眠不受调度延迟累积影响
+            struct timespec ts;
+            ts.tv_sec = target / 1000000;
+            ts.tv_nsec = (target % 1000000) * 1000;
+            while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+            }
+#else
+            std::this_thread::sleep_until(TimePoint(std::chrono::microseconds(target)));
+#endif
+            Tick_t now = NowMicro();
+            CalibrateSpin(now > target ? now - target : 0);
+        }
+        // 自旋到唤醒时间
+        Tick_t now;
+        while ((now = NowMicro()) < wakeup) {
+            CpuRelax();
+        }
+        if (now - wakeup > maxLateness_.load(std::memory_order_relaxed)) {
+            maxLateness_.store(now - wakeup, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::CalibrateSpin(Tick_t latency) {
+        // 平滑值按 1/8 权重更新，自旋时长取平滑值的两倍，兼顾偶发的较大延迟
+        Tick_t smoothed = sleepLatency_.load(std::memory_order_relaxed);
+        smoothed = smoothed == 0 ? latency : (smoothed * 7 + latency) / 8;
+        sleepLatency_.store(smoothed, std::memory_order_relaxed);
+        if (latency > maxSleepLatency_.load(std::memory_order_relaxed)) {
+            maxSleepLatency_.store(latency, std::memory_order_relaxed);
+        }
+        spinThreshold_.store(std::min(std::max(smoothed * 2, kMinSpin), kMaxSpin), std::memory_order_relaxed);
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    TimerStats Timer<T, Layout, Overflow>::GetStats() const {
+        TimerStats stats;
+        stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+        stats.notifies = notifies_.load(std::memory_order_relaxed);
+        stats.expired = expired_.load(std::memory_order_relaxed);
+        stats.precision = precision_.load(std::memory_order_relaxed);
+        stats.spinThreshold = spinThreshold_.load(std::memory_order_relaxed);
+        stats.sleepLatency = sleepLatency_.load(std::memory_order_relaxed);
+        stats.maxSleepLatency = maxSleepLatency_.load(std::memory_order_relaxed);
+        stats.maxWakeupLateness = maxLateness_.load(std::memory_order_relaxed);
+        stats.backlog = backlog_.load(std::memory_order_relaxed);
+        stats.maxBacklog = maxBacklog_.load(std::memory_order_relaxed);
+        stats.carryovers = carryovers_.load(std::memory_order_relaxed);
+        stats.maxCarryoverLateness = maxCarryoverLateness_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.backend = backend_;
+        stats.population = population_;
+        stats.migrations = migrations_;
+        return stats;
+    }
+
+    template <typename T, typename Layout, typename Overflow>
+    void Timer<T, Layout, Overflow>::TimerThreadFunc() {
+        // 待执行任务列表在各轮之间复用，避免每个 tick 分配内存
+        std::vector<TimerEntry<T>> expired_tasks;
+        // [pending, carried) 为上一轮超出预算积压的任务，排在本轮新到期的任务之前
+        size_t pending = 0;
+        size_t carried = 0;
+        while (!quit_) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                Tick_t now = CurrentTick();
+                while (backend_ == kWheelBackend && curTick_ <= now) {
+                    // 跳过没有任务的 tick
+                    Tick_t next = NextEventTick();
+                    if (next > now) {
+                        curTick_ = now + 1;
+                        break;
+                    }
+                    curTick_ = std::max(curTick_, next);
+                    Advance(expired_tasks);
+                }
+                if (backend_ != kWheelBackend) {
+                    DrainDue(now, expired_tasks);
                 }
-                for (auto task : expired_tasks) {
-                    task.Run();
+                horizon_.store(Horizon(), std::memory_order_relaxed);
+                Purge();
+                Adapt();
+                if (expired_tasks.empty()) {
+                    // 睡眠到最早的到期时间，在锁内发布唤醒 tick，只有添加更早的任务时才会被唤醒
+                    Tick_t earliest = EarliestTick();
+                    if (earliest == kIdleDeadline) {
+                        if (!quit_) {
+                            // 发布唤醒 tick 后再检查一次溢出存储，不加锁插入的任务不会被错过
+                            wakeTick_.store(kIdleDeadline, std::memory_order_seq_cst);
+                            if (heap_.GetEarliestTime() >= earliest) {
+                                cv_.wait(lock);
+                            }
+                            wakeTick_.store(0, std::memory_order_release);
+                        }
+                        continue;
+                    }
+                    Tick_t wakeup = earliest * resolution_;
+                    Tick_t nowMicro = NowMicro();
+                    if (wakeup > nowMicro && !quit_) {
+                        // 精确模式下条件变量只等待到唤醒时间前的窗口处，之后不再响应新任务
+                        Tick_t lead = precision_ ? kPrecisionWindow + spinThreshold_.load(std::memory_order_relaxed) : 0;
+                        if (wakeup - nowMicro > lead) {
+                            wakeTick_.store(earliest, std::memory_order_seq_cst);
+                            if (heap_.GetEarliestTime() >= earliest) {
+                                cv_.wait_for(lock, std::chrono::microseconds(wakeup - nowMicro - lead));
+                            }
+                            wakeTick_.store(0, std::memory_order_release);
+                        } else {
+                            // 精确睡眠期间不响应通知，同样发布唤醒 tick，更晚的新任务不必通知
+                            wakeTick_.store(earliest, std::memory_order_seq_cst);
+                            lock.unlock();
+                            PreciseSleep(wakeup);
+                            wakeTick_.store(0, std::memory_order_release);
+                        }
+                        wakeups_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    continue;
                 }
+            }
 
-                expired_tasks = wheels_[0].GetExpiredTimers(now);
-                for (auto task : expired_tasks) {
-                    heap_.AddTimer(task);
+            // 在锁外执行到期任务，达到预算后停止
+            size_t maxTimers = budgetTimers_.load(std::memory_order_relaxed);
+            Tick_t maxMicros = budgetMicros_.load(std::memory_order_relaxed);
+            Tick_t start = maxMicros > 0 ? NowMicro() : 0;
+            uint64_t count = 0;
+            while (pending < expired_tasks.size()) {
+                auto &entry = expired_tasks[pending];
+                if (pending < carried) {
+                    // 积压期间被重新放置的任务项已经失效，由新的任务项按新的到期时间执行
+                    if (!entry.Live()) {
+                        pending++;
+                        continue;
+                    }
+                    Tick_t deadline = entry.ExpireTime() * resolution_;
+                    Tick_t now = NowMicro();
+                    if (now > deadline && now - deadline > maxCarryoverLateness_.load(std::memory_order_relaxed)) {
+                        maxCarryoverLateness_.store(now - deadline, std::memory_order_relaxed);
+                    }
+                }
+                pending++;
+                // 执行期间被取消时由 EndRun 释放任务，回调不会在执行中被析构
+                auto &node = entry.Node();
+                if (node->BeginRun()) {
+                    entry.Task().Run();
+                    node->EndRun();
+                    count++;
+                }
+                if ((maxTimers > 0 && count >= maxTimers) || (maxMicros > 0 && NowMicro() - start >= maxMicros)) {
+                    break;
                 }
+            }
+            expired_.fetch_add(count, std::memory_order_relaxed);
+
+            size_t backlog = expired_tasks.size() - pending;
+            if (backlog == 0) {
+                expired_tasks.clear();
+                pending = 0;
+                carried = 0;
             } else {
-                // 等待最早的定时任务到期
-                Tick_t timeout = earliest_time - now;
-                std::unique_lock<std::mutex> lock(mutex_);
-                cv_.wait_for(lock, std::chrono::milliseconds(timeout));
+                carryovers_.fetch_add(expired_tasks.size() - std::max(pending, carried), std::memory_order_relaxed);
+                // 已执行的部分超过一半时再整体前移，均摊开销
+                if (pending >= backlog) {
+                    expired_tasks.erase(expired_tasks.begin(), expired_tasks.begin() + pending);
+                    pending = 0;
+                }
+                carried = expired_tasks.size();
+            }
+            backlog_.store(backlog, std::memory_order_relaxed);
+            if (backlog > maxBacklog_.load(std::memory_order_relaxed)) {
+                maxBacklog_.store(backlog, std::memory_order_relaxed);
             }
         }
     }
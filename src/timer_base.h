@@ -4,6 +4,11 @@
 #include <chrono>
 #include <functional>
 #include <iostream>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace CTimer {
 
@@ -12,6 +17,10 @@ namespace CTimer {
 
     // 最小时间间隔 10ms，即 1s=100tick, 1tick=10ms
     const uint32_t kMinInterval = 10;
+    // 最小时间粒度 100us
+    const uint64_t kMinResolution = 100;
+    // 最大时间粒度 1s
+    const uint64_t kMaxResolution = 1000 * 1000;
     // 最大时间间隔 24小时
     const uint32_t kMaxInterval = 24 * 60 * 60 * 1000;
     // 无效时间
@@ -40,6 +49,22 @@ namespace CTimer {
             .count();
     }
 
+    // 获取当前时间（微秒）
+    static Tick_t NowMicro() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   TimerClock::now().time_since_epoch())
+            .count();
+    }
+
+    // 自旋等待时降低功耗并让出流水线
+    inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
     // 格式化时间点
     static std::string TimePointF(TimePoint tp) {
         std::time_t t = std::chrono::system_clock::to_time_t(tp);
@@ -88,14 +113,20 @@ namespace CTimer {
          * @param cb 回调函数
          * @param interval 时间间隔
          */
-        TimerBase(const Callback &cb, Tick_t interval)
-            : cb_(cb), interval_(interval), expire_time_(Now() + interval) {}
+        TimerBase(Callback cb, Tick_t interval)
+            : cb_(std::move(cb)), interval_(interval), expire_time_(Now() + interval) {}
+
+        TimerBase(Tick_t expire_time, Callback cb)
+            : cb_(std::move(cb)), interval_(0), expire_time_(expire_time) {}
 
-        TimerBase(Tick_t expire_time, const Callback &cb)
-            : cb_(cb), interval_(0), expire_time_(expire_time) {}
+        TimerBase(Tick_t interval, Tick_t expire_time, Callback cb)
+            : cb_(std::move(cb)), interval_(interval), expire_time_(expire_time) {}
 
-        TimerBase(Tick_t interval, Tick_t expire_time, const Callback &cb)
-            : cb_(cb), interval_(interval), expire_time_(expire_time) {}
+        // 声明了虚析构函数，需要显式保留移动操作，否则移动时会复制回调函数
+        TimerBase(const TimerBase &) = default;
+        TimerBase(TimerBase &&) = default;
+        TimerBase &operator=(const TimerBase &) = default;
+        TimerBase &operator=(TimerBase &&) = default;
 
         // 获取到期时间
         virtual Tick_t ExpireTime() const = 0;
@@ -114,20 +145,21 @@ namespace CTimer {
             return *(cb_.target<void()>()) == *(other.cb_.target<void()>()) && interval_ == other.interval_ && expire_time_ == other.expire_time_;
         }
 
+        // 按到期时间排序
         bool operator>(const TimerBase &other) const {
-            return *(cb_.target<void()>()) == *(other.cb_.target<void()>()) && interval_ == other.interval_ && expire_time_ > other.expire_time_;
+            return expire_time_ > other.expire_time_;
         }
 
         bool operator<(const TimerBase &other) const {
-            return *(cb_.target<void()>()) == *(other.cb_.target<void()>()) && interval_ == other.interval_ && expire_time_ < other.expire_time_;
+            return expire_time_ < other.expire_time_;
         }
 
         bool operator>=(const TimerBase &other) const {
-            return *(cb_.target<void()>()) == *(other.cb_.target<void()>()) && interval_ == other.interval_ && expire_time_ >= other.expire_time_;
+            return expire_time_ >= other.expire_time_;
         }
 
         bool operator<=(const TimerBase &other) const {
-            return *(cb_.target<void()>()) == *(other.cb_.target<void()>()) && interval_ == other.interval_ && expire_time_ <= other.expire_time_;
+            return expire_time_ <= other.expire_time_;
         }
 
     protected:
@@ -0,0 +1,51 @@
+#ifndef _TIMER_ENTRY_H_
+#define _TIMER_ENTRY_H_
+
+#include <memory>
+
+#include "timer_base.h"
+#include "timer_node.h"
+
+namespace CTimer {
+
+    // 时间轮中的定时任务项，保存插入时换算好的到期 tick、任务节点和放置序号
+    template <typename T>
+    class TimerEntry {
+    public:
+        TimerEntry(Tick_t tick, const std::shared_ptr<TimerNode<T>> &node, uint64_t seq)
+            : tick_(tick), node_(node), seq_(seq) {}
+
+        // 获取到期 tick
+        Tick_t ExpireTime() const { return tick_; }
+
+        void SetExpireTime(Tick_t tick) { tick_ = tick; }
+
+        const std::shared_ptr<TimerNode<T>> &Node() const { return node_; }
+
+        T &Task() const { return node_->Task(); }
+
+        uint64_t Seq() const { return seq_; }
+
+        // 节点未取消且没有被重新放置时任务项有效
+        bool Live() const { return !node_->Cancelled() && node_->Seq() == seq_; }
+
+        bool operator==(const TimerEntry &other) const {
+            return tick_ == other.tick_ && node_ == other.node_ && seq_ == other.seq_;
+        }
+
+        bool operator>(const TimerEntry &other) const { return tick_ > other.tick_; }
+
+        bool operator<(const TimerEntry &other) const { return tick_ < other.tick_; }
+
+        bool operator>=(const TimerEntry &other) const { return tick_ >= other.tick_; }
+
+        bool operator<=(const TimerEntry &other) const { return tick_ <= other.tick_; }
+
+    private:
+        Tick_t tick_;                        // 到期 tick
+        std::shared_ptr<TimerNode<T>> node_; // 定时任务节点
+        uint64_t seq_;                       // 放置序号
+    };
+} // namespace CTimer
+
+#endif /* _TIMER_ENTRY_H_ */
@@ -0,0 +1,36 @@
+#ifndef _TIMER_GROUP_H_
+#define _TIMER_GROUP_H_
+
+#include "timer_node.h"
+
+namespace CTimer {
+
+    /**
+     * @brief 定时任务分组
+     *
+     * 加入分组的定时任务通过侵入式链表挂在分组上，CancelGroup 只遍历分组成员，
+     * 不需要扫描时间轮和最小堆。分组销毁时自动取消所有成员
+     */
+    class TimerGroup {
+    public:
+        TimerGroup() : list_(std::make_shared<TimerGroupList>()) {}
+
+        ~TimerGroup() { CancelGroup(); }
+
+        TimerGroup(const TimerGroup &) = delete;
+        TimerGroup &operator=(const TimerGroup &) = delete;
+
+        // 取消分组内所有定时任务，返回取消的数量
+        size_t CancelGroup() { return list_->CancelAll(); }
+
+        // 获取分组内的定时任务数量
+        size_t Size() const { return list_->Size(); }
+
+        const std::shared_ptr<TimerGroupList> &List() const { return list_; }
+
+    private:
+        std::shared_ptr<TimerGroupList> list_; // 分组成员链表，节点持有其引用
+    };
+} // namespace CTimer
+
+#endif /* _TIMER_GROUP_H_ */
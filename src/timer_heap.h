@@ -4,6 +4,7 @@
 #include <vector>
 #include <algorithm>
 #include <mutex>
+#include <utility>
 
 #include "timer_task.h"
 
@@ -18,6 +19,8 @@ namespace CTimer {
         // 插入定时任务
         void AddTimer(const T &task);
 
+        void AddTimer(T &&task);
+
         // 删除定时任务
         void RemoveTimer(const T &task);
 
@@ -27,6 +30,22 @@ namespace CTimer {
         // 获取所有到期的定时任务
         std::vector<T> GetExpiredTimers();
 
+        // 获取到期时间不晚于 expire_time 的定时任务
+        std::vector<T> GetExpiredTimers(Tick_t expire_time);
+
+        /**
+         * @brief 按到期时间顺序弹出不晚于 expire_time 的任务，逐个移交给 visit，不分配内存
+         *
+         * visit 在锁外调用，其中可以插入到期时间晚于 expire_time 的任务
+         *
+         * @return 弹出的任务数量
+         */
+        template <typename Visitor>
+        size_t DrainExpired(Tick_t expire_time, Visitor &&visit);
+
+        // 弹出不晚于 expire_time 的任务，追加到调用方复用的 buffer 中
+        size_t DrainExpired(Tick_t expire_time, std::vector<T> &buffer);
+
     private:
         // 调整堆
         void SiftUp(int index);
@@ -38,7 +57,7 @@ namespace CTimer {
 
 #ifdef TIMER_HEAP_IMPLEMENTATION
     template <typename T>
-    TimerHeap<T>::TimerHeap() : tasks_(0), mutex_() {
+    TimerHeap<T>::TimerHeap() : tasks_(), mutex_() {
     }
 
     template <typename T>
@@ -48,6 +67,13 @@ namespace CTimer {
         SiftUp(tasks_.size() - 1);
     }
 
+    template <typename T>
+    void TimerHeap<T>::AddTimer(T &&task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        SiftUp(tasks_.size() - 1);
+    }
+
     template <typename T>
     void TimerHeap<T>::RemoveTimer(const T &task) {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -73,17 +99,52 @@ namespace CTimer {
 
     template <typename T>
     std::vector<T> TimerHeap<T>::GetExpiredTimers() {
-        std::lock_guard<std::mutex> lock(mutex_);
+        return GetExpiredTimers(Now());
+    }
+
+    template <typename T>
+    std::vector<T> TimerHeap<T>::GetExpiredTimers(Tick_t expire_time) {
         std::vector<T> tasks;
-        while (!tasks_.empty() && tasks_.front().ExpireTime() <= Now()) {
-            tasks.push_back(tasks_.front());
-            tasks_.erase(tasks_.begin());
+        DrainExpired(expire_time, tasks);
+        return tasks;
+    }
+
+    template <typename T>
+    template <typename Visitor>
+    size_t TimerHeap<T>::DrainExpired(Tick_t expire_time, Visitor &&visit) {
+        size_t count = 0;
+        for (;;) {
+            // 每次只在锁内弹出一个任务，访问时不持有锁
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (tasks_.empty() || tasks_.front().ExpireTime() > expire_time) {
+                break;
+            }
+            std::pop_heap(tasks_.begin(), tasks_.end(), [](const T &a, const T &b) {
+                return a > b;
+            });
+            T task(std::move(tasks_.back()));
+            tasks_.pop_back();
+            lock.unlock();
+            visit(std::move(task));
+            count++;
         }
+        return count;
+    }
 
-        std::make_heap(tasks_.begin(), tasks_.end(), [](const T &a, const T &b) {
-            return a > b;
-        });
-        return tasks;
+    template <typename T>
+    size_t TimerHeap<T>::DrainExpired(Tick_t expire_time, std::vector<T> &buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        while (!tasks_.empty() && tasks_.front().ExpireTime() <= expire_time) {
+            std::pop_heap(tasks_.begin(), tasks_.end(), [](const T &a, const T &b) {
+                return a > b;
+            });
+            // 弹出堆顶后堆顶即为剩余任务中最早到期的
+            buffer.push_back(std::move(tasks_.back()));
+            tasks_.pop_back();
+            count++;
+        }
+        return count;
     }
 
     template <typename T>
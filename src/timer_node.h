@@ -0,0 +1,261 @@
+#ifndef _TIMER_NODE_H_
+#define _TIMER_NODE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "timer_base.h"
+
+namespace CTimer {
+
+    class TimerNodeBase;
+
+    // 空闲节点的到期时间，表示节点不在定时器中
+    const Tick_t kIdleDeadline = ~Tick_t(0);
+
+    // 分组内定时任务节点组成的侵入式双向链表
+    class TimerGroupList {
+    public:
+        TimerGroupList() : head_(nullptr), size_(0) {}
+
+        // 将节点挂到链表头部
+        void Link(TimerNodeBase *node);
+
+        // 将节点从链表中摘除，节点已被摘除时不做处理
+        void Unlink(TimerNodeBase *node);
+
+        // 取消并摘除所有节点，在锁外释放各节点的任务，返回取消的数量
+        size_t CancelAll();
+
+        size_t Size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return size_;
+        }
+
+    private:
+        TimerNodeBase *head_; // 链表头
+        size_t size_;         // 节点数量
+        mutable std::mutex mutex_;
+    };
+
+    // 定时任务节点基类，保存到期时间、取消标记和分组链表指针
+    class TimerNodeBase : public std::enable_shared_from_this<TimerNodeBase> {
+    public:
+        explicit TimerNodeBase(Tick_t deadline)
+            : deadline_(deadline), seq_(0), owner_(nullptr), state_(0), linked_(false), groupPrev_(nullptr), groupNext_(nullptr) {}
+
+        TimerNodeBase(const TimerNodeBase &) = delete;
+        TimerNodeBase &operator=(const TimerNodeBase &) = delete;
+
+        virtual ~TimerNodeBase() { LeaveGroup(); }
+
+        // 获取到期时间（毫秒），空闲时为 kIdleDeadline
+        Tick_t Deadline() const { return deadline_.load(std::memory_order_acquire); }
+
+        void SetDeadline(Tick_t deadline) { deadline_.store(deadline, std::memory_order_release); }
+
+        bool CompareExchangeDeadline(Tick_t &expected, Tick_t deadline) {
+            return deadline_.compare_exchange_weak(expected, deadline, std::memory_order_acq_rel, std::memory_order_acquire);
+        }
+
+        // 放置序号，每次重新放置时递增，序号不一致的任务项已经失效，只在定时器锁内递增
+        uint64_t Seq() const { return seq_.load(std::memory_order_acquire); }
+
+        uint64_t NextSeq() { return seq_.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+        // 创建节点的定时器
+        const void *Owner() const { return owner_; }
+
+        // cancelled 为定时器中已取消尚未清理的节点计数，节点取消时递增
+        void SetOwner(const void *owner, const std::shared_ptr<std::atomic<size_t>> &cancelled = nullptr) {
+            owner_ = owner;
+            cancelled_ = cancelled;
+        }
+
+        bool Cancelled() const { return (state_.load(std::memory_order_acquire) & kCancelled) != 0; }
+
+        /**
+         * @brief 取消节点，没有在执行时立即释放任务及其回调持有的资源
+         *
+         * 任务项留在存储中，由定时器线程批量清理或轮到所在槽位时丢弃
+         *
+         * @return 已经取消过时返回 false
+         */
+        bool Cancel() {
+            uint32_t state = MarkCancelled();
+            if (state & kCancelled) {
+                return false;
+            }
+            if (!(state & kRunning)) {
+                ReleaseTask();
+            }
+            return true;
+        }
+
+        // 开始执行任务，已取消时返回 false，只由定时器线程调用
+        bool BeginRun() {
+            uint32_t state = state_.load(std::memory_order_acquire);
+            while (!(state & kCancelled)) {
+                if (state_.compare_exchange_weak(state, state | kRunning, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 执行结束，执行期间被取消时由执行线程释放任务
+        void EndRun() {
+            if (state_.fetch_and(~kRunning, std::memory_order_acq_rel) & kCancelled) {
+                ReleaseTask();
+            }
+        }
+
+        // 加入分组，只能在节点对其他线程可见之前调用一次
+        void JoinGroup(const std::shared_ptr<TimerGroupList> &group) {
+            group_ = group;
+            group_->Link(this);
+        }
+
+    protected:
+        // 释放任务持有的资源，取消后只调用一次
+        virtual void ReleaseTask() = 0;
+
+        // 退出分组，派生类析构时先调用，保证分组取消时不会访问已析构的任务
+        void LeaveGroup() {
+            if (group_) {
+                group_->Unlink(this);
+            }
+        }
+
+    private:
+        friend class TimerGroupList;
+
+        static const uint32_t kCancelled = 1; // 已取消
+        static const uint32_t kRunning = 2;   // 正在执行
+
+        // 置取消标记，返回原来的状态
+        uint32_t MarkCancelled() {
+            uint32_t state = state_.fetch_or(kCancelled, std::memory_order_acq_rel);
+            if (!(state & kCancelled) && cancelled_) {
+                cancelled_->fetch_add(1, std::memory_order_relaxed);
+            }
+            return state;
+        }
+
+        std::atomic<Tick_t> deadline_;                   // 到期时间，延后时只更新该值
+        std::atomic<uint64_t> seq_;                      // 放置序号
+        const void *owner_;                              // 创建节点的定时器
+        std::shared_ptr<std::atomic<size_t>> cancelled_; // 定时器中已取消尚未清理的节点计数
+        std::atomic<uint32_t> state_;                    // 取消和执行状态
+        std::shared_ptr<TimerGroupList> group_;          // 所属分组
+        bool linked_;                                    // 是否仍在分组链表中，由分组锁保护
+        TimerNodeBase *groupPrev_;                       // 分组链表前驱
+        TimerNodeBase *groupNext_;                       // 分组链表后继
+    };
+
+    inline void TimerGroupList::Link(TimerNodeBase *node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        node->groupPrev_ = nullptr;
+        node->groupNext_ = head_;
+        if (head_) {
+            head_->groupPrev_ = node;
+        }
+        head_ = node;
+        node->linked_ = true;
+        size_++;
+    }
+
+    inline void TimerGroupList::Unlink(TimerNodeBase *node) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!node->linked_) {
+            return;
+        }
+        if (node->groupPrev_) {
+            node->groupPrev_->groupNext_ = node->groupNext_;
+        } else {
+            head_ = node->groupNext_;
+        }
+        if (node->groupNext_) {
+            node->groupNext_->groupPrev_ = node->groupPrev_;
+        }
+        node->groupPrev_ = node->groupNext_ = nullptr;
+        node->linked_ = false;
+        size_--;
+    }
+
+    inline size_t TimerGroupList::CancelAll() {
+        // 回调析构时可能访问分组，任务在锁外释放；正在析构的节点无法获取引用，由析构函数释放
+        std::vector<std::shared_ptr<TimerNodeBase>> released;
+        size_t count;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count = size_;
+            released.reserve(count);
+            for (TimerNodeBase *node = head_; node != nullptr;) {
+                TimerNodeBase *next = node->groupNext_;
+                uint32_t state = node->MarkCancelled();
+                if (!(state & (TimerNodeBase::kCancelled | TimerNodeBase::kRunning))) {
+                    if (auto self = node->weak_from_this().lock()) {
+                        released.push_back(std::move(self));
+                    }
+                }
+                node->groupPrev_ = node->groupNext_ = nullptr;
+                node->linked_ = false;
+                node = next;
+            }
+            head_ = nullptr;
+            size_ = 0;
+        }
+        for (auto &node : released) {
+            node->ReleaseTask();
+        }
+        return count;
+    }
+
+    // 定时任务节点，时间轮和最小堆中保存的是指向节点的指针
+    template <typename T>
+    class TimerNode : public TimerNodeBase {
+    public:
+        explicit TimerNode(const T &task) : TimerNodeBase(task.ExpireTime()), task_(task) {}
+
+        explicit TimerNode(T &&task) : TimerNodeBase(task.ExpireTime()), task_(std::move(task)) {}
+
+        // 在节点中原地构造定时任务
+        template <typename... Args>
+        explicit TimerNode(std::in_place_t, Args &&...args)
+            : TimerNodeBase(kIdleDeadline), task_(std::forward<Args>(args)...) {
+            SetDeadline(task_.ExpireTime());
+        }
+
+        ~TimerNode() { LeaveGroup(); }
+
+        T &Task() { return task_; }
+
+    protected:
+        // 移出任务后析构，回调捕获的资源随之释放
+        void ReleaseTask() override { T released(std::move(task_)); }
+
+    private:
+        T task_; // 定时任务
+    };
+
+    // 定时任务标识，持有任务节点，用于取消和重新设置到期时间
+    class TimerId {
+    public:
+        TimerId() = default;
+
+        explicit TimerId(const std::shared_ptr<TimerNodeBase> &node) : node_(node) {}
+
+        const std::shared_ptr<TimerNodeBase> &Node() const { return node_; }
+
+        explicit operator bool() const { return node_ != nullptr; }
+
+    private:
+        std::shared_ptr<TimerNodeBase> node_; // 定时任务节点
+    };
+} // namespace CTimer
+
+#endif /* _TIMER_NODE_H_ */
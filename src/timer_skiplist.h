@@ -0,0 +1,340 @@
+#ifndef _TIMER_SKIPLIST_H_
+#define _TIMER_SKIPLIST_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "timer_base.h"
+
+namespace CTimer {
+
+    // 跳表最大层数，每升一层保留 1/4 的节点
+    const int kSkipListLevels = 16;
+
+    /**
+     * @brief 按到期时间排序的无锁跳表
+     *
+     * 多个线程可以并发插入，同一时刻只能有一个线程弹出任务（Timer 中由定时器锁保证）。
+     * 插入只使用 CAS；弹出的节点按纪元回收，等所有可能看到它的插入线程离开后才释放。
+     * 接口与 TimerHeap 一致，可以作为 Timer 的溢出存储
+     */
+    template <typename T>
+    class TimerSkipList {
+    public:
+        TimerSkipList();
+        ~TimerSkipList();
+
+        TimerSkipList(const TimerSkipList &) = delete;
+        TimerSkipList &operator=(const TimerSkipList &) = delete;
+
+        // 插入定时任务，可并发调用
+        void AddTimer(const T &task) { Insert(Create(task)); }
+
+        void AddTimer(T &&task) { Insert(Create(std::move(task))); }
+
+        // 获取已链接完成的任务中最早的到期时间，与 DrainExpired 能弹出的任务一致
+        Tick_t GetEarliestTime() const;
+
+        /**
+         * @brief 按到期时间顺序弹出不晚于 expire_time 的任务，逐个移交给 visit，不加锁
+         *
+         * 只能有一个线程弹出，visit 中可以插入新任务
+         *
+         * @return 弹出的任务数量
+         */
+        template <typename Visitor>
+        size_t DrainExpired(Tick_t expire_time, Visitor &&visit);
+
+        // 弹出不晚于 expire_time 的任务，追加到调用方复用的 buffer 中
+        size_t DrainExpired(Tick_t expire_time, std::vector<T> &buffer) {
+            return DrainExpired(expire_time, [&buffer](T &&task) { buffer.push_back(std::move(task)); });
+        }
+
+    private:
+        struct Node {
+            Node() : tick(0), serial(0), level(0), linked(false) {}
+
+            T &Value() { return *reinterpret_cast<T *>(&storage); }
+
+            Tick_t tick;                                                  // 到期时间
+            uint64_t serial;                                              // 插入序号，到期时间相同时按插入顺序排列
+            int level;                                                    // 层数
+            std::atomic<bool> linked;                                     // 各层都已链接，之后才能弹出
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; // 定时任务，头节点不构造
+            std::atomic<uintptr_t> next[1];                               // 各层后继，最低位为删除标记，实际长度为 level
+        };
+
+        // 在当前纪元登记访问，析构时注销
+        class Guard {
+        public:
+            explicit Guard(const TimerSkipList &list);
+            ~Guard() { slot_->fetch_sub(1, std::memory_order_release); }
+
+        private:
+            std::atomic<uint64_t> *slot_;
+        };
+
+        static const uintptr_t kMark = 1;
+
+        static Node *Ptr(uintptr_t link) { return reinterpret_cast<Node *>(link & ~kMark); }
+
+        static uintptr_t Link(Node *node) { return reinterpret_cast<uintptr_t>(node); }
+
+        static bool Marked(uintptr_t link) { return (link & kMark) != 0; }
+
+        // a 是否排在 b 之前
+        static bool Before(const Node *a, const Node *b) {
+            return a->tick < b->tick || (a->tick == b->tick && a->serial < b->serial);
+        }
+
+        static int RandomLevel();
+
+        // 分配 level 层的节点，不构造定时任务
+        static Node *Allocate(int level);
+
+        // 析构定时任务并释放节点
+        static void Free(Node *node);
+
+        template <typename U>
+        Node *Create(U &&task);
+
+        // 查找每层中 node 的前驱和后继，顺带摘除已标记删除的节点
+        void Find(const Node *node, Node **preds, Node **succs);
+
+        void Insert(Node *node);
+
+        // 标记并逐层摘除已链接完成的节点，只由弹出线程调用
+        void Unlink(Node *node);
+
+        // 推进纪元，释放不再可见的节点
+        void Reclaim();
+
+        Node *head_;                              // 头节点，拥有全部层
+        std::atomic<uint64_t> serial_;            // 插入序号
+        std::atomic<uint64_t> epoch_;             // 全局纪元，只由弹出线程推进
+        mutable std::atomic<uint64_t> active_[3]; // 各纪元中正在访问的线程数
+        std::vector<Node *> retired_[3];          // 各纪元中摘除的节点，只由弹出线程访问
+    };
+
+    template <typename T>
+    TimerSkipList<T>::Guard::Guard(const TimerSkipList &list) {
+        // 登记后纪元未变才有效，否则回收线程可能已经越过该纪元
+        for (;;) {
+            uint64_t epoch = list.epoch_.load(std::memory_order_seq_cst);
+            slot_ = &list.active_[epoch % 3];
+            slot_->fetch_add(1, std::memory_order_seq_cst);
+            if (list.epoch_.load(std::memory_order_seq_cst) == epoch) {
+                break;
+            }
+            slot_->fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    template <typename T>
+    TimerSkipList<T>::TimerSkipList() : head_(Allocate(kSkipListLevels)), serial_(0), epoch_(0) {
+        for (auto &active : active_) {
+            active.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    TimerSkipList<T>::~TimerSkipList() {
+        Node *node = Ptr(head_->next[0].load(std::memory_order_acquire));
+        while (node) {
+            Node *next = Ptr(node->next[0].load(std::memory_order_relaxed));
+            Free(node);
+            node = next;
+        }
+        for (auto &retired : retired_) {
+            for (Node *node : retired) {
+                Free(node);
+            }
+        }
+        head_->~Node();
+        ::operator delete(head_);
+    }
+
+    template <typename T>
+    int TimerSkipList<T>::RandomLevel() {
+        // xorshift 随机数，每两位为 0 时升一层
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) ^ std::chrono::steady_clock::now().time_since_epoch().count();
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        uint64_t bits = state;
+        int level = 1;
+        while (level < kSkipListLevels && (bits & 3) == 0) {
+            level++;
+            bits >>= 2;
+        }
+        return level;
+    }
+
+    template <typename T>
+    typename TimerSkipList<T>::Node *TimerSkipList<T>::Allocate(int level) {
+        void *memory = ::operator new(sizeof(Node) + (level - 1) * sizeof(std::atomic<uintptr_t>));
+        Node *node = new (memory) Node();
+        node->level = level;
+        for (int i = 0; i < level; i++) {
+            new (&node->next[i]) std::atomic<uintptr_t>(0);
+        }
+        return node;
+    }
+
+    template <typename T>
+    void TimerSkipList<T>::Free(Node *node) {
+        node->Value().~T();
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    template <typename T>
+    template <typename U>
+    typename TimerSkipList<T>::Node *TimerSkipList<T>::Create(U &&task) {
+        Node *node = Allocate(RandomLevel());
+        new (&node->storage) T(std::forward<U>(task));
+        node->tick = node->Value().ExpireTime();
+        node->serial = serial_.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    template <typename T>
+    Tick_t TimerSkipList<T>::GetEarliestTime() const {
+        Guard guard(*this);
+        Node *node = Ptr(head_->next[0].load(std::memory_order_seq_cst));
+        // 跳过仍在链接高层或正在删除的节点
+        while (node && (!node->linked.load(std::memory_order_seq_cst) || Marked(node->next[0].load(std::memory_order_acquire)))) {
+            node = Ptr(node->next[0].load(std::memory_order_acquire));
+        }
+        return node ? node->tick : Tick_t(kInvalidTime);
+    }
+
+    template <typename T>
+    void TimerSkipList<T>::Find(const Node *node, Node **preds, Node **succs) {
+    retry:
+        Node *pred = head_;
+        for (int i = kSkipListLevels - 1; i >= 0; i--) {
+            Node *curr = Ptr(pred->next[i].load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next[i].load(std::memory_order_acquire);
+                if (Marked(succ)) {
+                    // 协助摘除正在删除的节点，前驱已被标记时从头查找
+                    uintptr_t expected = Link(curr);
+                    if (!pred->next[i].compare_exchange_strong(expected, succ & ~kMark)) {
+                        goto retry;
+                    }
+                    curr = Ptr(succ);
+                    continue;
+                }
+                if (!Before(curr, node)) {
+                    break;
+                }
+                pred = curr;
+                curr = Ptr(succ);
+            }
+            preds[i] = pred;
+            succs[i] = curr;
+        }
+    }
+
+    template <typename T>
+    void TimerSkipList<T>::Insert(Node *node) {
+        Guard guard(*this);
+        Node *preds[kSkipListLevels];
+        Node *succs[kSkipListLevels];
+        // 先链接最低层，之后节点即可被查找到
+        for (;;) {
+            Find(node, preds, succs);
+            node->next[0].store(Link(succs[0]), std::memory_order_relaxed);
+            uintptr_t expected = Link(succs[0]);
+            if (preds[0]->next[0].compare_exchange_strong(expected, Link(node))) {
+                break;
+            }
+        }
+        // 节点在 linked 置位前不会被弹出，高层后继不会被标记
+        for (int i = 1; i < node->level; i++) {
+            for (;;) {
+                node->next[i].store(Link(succs[i]), std::memory_order_relaxed);
+                uintptr_t expected = Link(succs[i]);
+                if (preds[i]->next[i].compare_exchange_strong(expected, Link(node))) {
+                    break;
+                }
+                Find(node, preds, succs);
+            }
+        }
+        node->linked.store(true, std::memory_order_seq_cst);
+    }
+
+    template <typename T>
+    void TimerSkipList<T>::Unlink(Node *node) {
+        // 自顶向下标记，之后不会再有节点插在它后面
+        for (int i = node->level - 1; i >= 0; i--) {
+            node->next[i].fetch_or(kMark);
+        }
+        for (int i = node->level - 1; i >= 0; i--) {
+            for (;;) {
+                // 排在它前面的只有刚插入的更早任务，从头查找前驱
+                Node *pred = head_;
+                Node *curr = Ptr(pred->next[i].load(std::memory_order_acquire));
+                while (curr && curr != node && Before(curr, node)) {
+                    pred = curr;
+                    curr = Ptr(curr->next[i].load(std::memory_order_acquire));
+                }
+                if (curr != node) {
+                    // 已被插入线程摘除
+                    break;
+                }
+                uintptr_t expected = Link(node);
+                uintptr_t succ = node->next[i].load(std::memory_order_acquire) & ~kMark;
+                if (pred->next[i].compare_exchange_strong(expected, succ)) {
+                    break;
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void TimerSkipList<T>::Reclaim() {
+        // 没有线程停留在上一纪元时推进纪元，上一纪元摘除的节点不再可见
+        uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        size_t previous = (epoch + 2) % 3;
+        if (active_[previous].load(std::memory_order_seq_cst) != 0) {
+            return;
+        }
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+        for (Node *node : retired_[previous]) {
+            Free(node);
+        }
+        retired_[previous].clear();
+    }
+
+    template <typename T>
+    template <typename Visitor>
+    size_t TimerSkipList<T>::DrainExpired(Tick_t expire_time, Visitor &&visit) {
+        Reclaim();
+        size_t count = 0;
+        for (;;) {
+            // 跳过仍在链接高层的节点，插入线程被抢占时不阻塞后面已到期的任务
+            Node *first = Ptr(head_->next[0].load(std::memory_order_acquire));
+            while (first && first->tick <= expire_time && !first->linked.load(std::memory_order_acquire)) {
+                first = Ptr(first->next[0].load(std::memory_order_acquire));
+            }
+            if (!first || first->tick > expire_time) {
+                break;
+            }
+            Unlink(first);
+            T task(std::move(first->Value()));
+            retired_[epoch_.load(std::memory_order_relaxed) % 3].push_back(first);
+            visit(std::move(task));
+            count++;
+        }
+        return count;
+    }
+} // namespace CTimer
+
+#endif /* _TIMER_SKIPLIST_H_ */
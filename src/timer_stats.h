@@ -0,0 +1,38 @@
+#ifndef _TIMER_STATS_H_
+#define _TIMER_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "timer_base.h"
+
+namespace CTimer {
+
+    // 定时器存储结构
+    enum TimerBackend {
+        kSmallBackend, // 有序小数组
+        kHeapBackend,  // 最小堆
+        kWheelBackend, // 多层时间轮，超出范围的任务放入最小堆
+    };
+
+    // 定时器运行统计
+    struct TimerStats {
+        uint64_t wakeups = 0;           // 定时器线程被唤醒的次数
+        uint64_t notifies = 0;          // 添加任务时唤醒定时器线程的次数
+        uint64_t expired = 0;           // 已执行的任务数
+        bool precision = false;         // 是否开启精确模式
+        Tick_t spinThreshold = 0;       // 精确模式的自旋时长（微秒），根据睡眠唤醒延迟自动校准
+        Tick_t sleepLatency = 0;        // 精确模式睡眠唤醒延迟的平滑值（微秒）
+        Tick_t maxSleepLatency = 0;     // 精确模式最大睡眠唤醒延迟（微秒）
+        Tick_t maxWakeupLateness = 0;   // 精确模式醒来时晚于唤醒时间的最大值（微秒）
+        TimerBackend backend = kSmallBackend; // 当前存储结构
+        size_t population = 0;          // 存储中的任务项数量，包括已取消尚未清理的
+        uint64_t migrations = 0;        // 切换存储结构的次数
+        size_t backlog = 0;             // 超出每轮预算积压的到期任务数
+        size_t maxBacklog = 0;          // 最大积压任务数
+        uint64_t carryovers = 0;        // 超出预算留到下一轮执行的任务数
+        Tick_t maxCarryoverLateness = 0; // 积压任务执行时晚于到期时间的最大值（微秒）
+    };
+} // namespace CTimer
+
+#endif /* _TIMER_STATS_H_ */
@@ -1,12 +1,14 @@
 #ifndef _TIMER_TASK_H_
 #define _TIMER_TASK_H_
 
+#include <utility>
+
 #include "timer_base.h"
 
 /**
  * @brief 时间轮算法
  * 32位tick可以分为8 6 6 6 6,共5个度量，即 111111 111111 111111 111111 11111111，
- * 64位tick可以分为
+ * 64位tick可以分为8 6 6 6 6 6 6 6 6 8,共10个度量，见 WheelLayout32/WheelLayout64
  *
  */
 
@@ -23,14 +25,14 @@ namespace CTimer {
          * @param cb 回调函数
          * @param interval 时间间隔
          */
-        TimerTask(const Callback &cb, Tick_t interval)
-            : TimerBase(cb, interval) {}
+        TimerTask(Callback cb, Tick_t interval)
+            : TimerBase(std::move(cb), interval) {}
 
-        TimerTask(Tick_t expire_time, const Callback &cb)
-            : TimerBase(expire_time, cb) {}
+        TimerTask(Tick_t expire_time, Callback cb)
+            : TimerBase(expire_time, std::move(cb)) {}
 
-        TimerTask(Tick_t interval, Tick_t expire_time, const Callback &cb)
-            : TimerBase(interval, expire_time, cb) {}
+        TimerTask(Tick_t interval, Tick_t expire_time, Callback cb)
+            : TimerBase(interval, expire_time, std::move(cb)) {}
 
         // 获取到期时间
         virtual Tick_t ExpireTime() const { return expire_time_; }
@@ -3,13 +3,31 @@
 
 #include <vector>
 #include <queue>
+#include <memory>
+#include <cstdint>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "timer_task.h"
 #include "min_heap.h"
 
 namespace CTimer {
 
-    // 时间轮类
+    // 时间轮中缓存的空槽位数量上限
+    const size_t kSpareSlots = 4;
+    // 缓存的空槽位容量上限，突发之后容量更大的槽位直接释放
+    const size_t kSpareCapacity = 64;
+
+    /**
+     * @brief 时间轮类
+     *
+     * 槽位在首次插入时创建，清空后释放，少量空槽位缓存复用。槽位数组在时间轮变空后保留，
+     * 任务数在 0 和 1 之间反复变化时不会反复分配，长期不用时调用方通过 Shrink 释放。
+     * 非空槽位记录在位图中，查找下一个非空槽位只需按字 ctz
+     */
     template <typename T>
     class TimerWheel {
     public:
@@ -20,15 +38,48 @@ namespace CTimer {
         // 插入定时任务
         void AddTimer(const T &task);
 
+        void AddTimer(T &&task);
+
+        // 按指定 tick 插入定时任务
+        void AddTimer(const T &task, Tick_t tick);
+
+        void AddTimer(T &&task, Tick_t tick);
+
         // 删除定时任务
         void RemoveTimer(const T &task);
 
         // 获取时间轮中最早的到期时间
         Tick_t GetEarliestTime() const;
 
+        // 从 from 开始循环查找第一个非空槽位，没有时返回 -1
+        int NextOccupiedSlot(int from) const;
+
+        // 获取槽位中最早的到期时间
+        Tick_t GetSlotEarliestTime(int slotIndex) const;
+
         // 获取大于当前时间段所有定时任务
         std::vector<T> GetExpiredTimers(Tick_t expire_time);
 
+        /**
+         * @brief 取出 expire_time 所在槽位的全部任务，逐个移交给 visit，不分配内存
+         *
+         * 槽位先从时间轮中摘下再访问，visit 中可以向时间轮插入任务。任务按存储顺序访问
+         *
+         * @return 取出的任务数量
+         */
+        template <typename Visitor>
+        size_t DrainExpired(Tick_t expire_time, Visitor &&visit);
+
+        // 取出 expire_time 所在槽位的全部任务，追加到调用方复用的 buffer 中
+        size_t DrainExpired(Tick_t expire_time, std::vector<T> &buffer);
+
+        // 取出时间轮中的全部任务，visit 中不能再向本时间轮插入任务
+        template <typename Visitor>
+        size_t DrainAll(Visitor &&visit);
+
+        // 时间轮为空时释放槽位数组和缓存的空槽位
+        void Shrink();
+
         // 处理到期任务
         void Tick();
 
@@ -36,30 +87,82 @@ namespace CTimer {
         int GetWheelMask() const;
         std::vector<MinHeap<T> *> GetSlots() const;
 
+        // 获取已创建的槽位数量
+        size_t GetSlotCount() const;
+
     private:
         // 获取定时任务在时间轮中的位置
         int GetSlotIndex(Tick_t expire_time) const;
 
+        // 获取槽位，不存在时创建
+        MinHeap<T> &MaterializeSlot(int slotIndex);
+
+        // 槽位清空后释放，少量空槽位缓存起来复用
+        void ReleaseSlot(int slotIndex);
+
+        // 从时间轮中摘下槽位
+        std::unique_ptr<MinHeap<T>> DetachSlot(int slotIndex);
+
+        // 回收已清空的槽位
+        void RecycleSlot(std::unique_ptr<MinHeap<T>> slot);
+
     private:
-        int shiftBits_;                   // 时间轮每个槽位所占二进制位数
-        int wheelMask_;                   // 时间轮大小掩码（用于取模运算）
-        Tick_t curTick_;                  // 当前时间轮所在位置的 tick 值
-        std::vector<MinHeap<T> *> slots_; // 每个槽位对应的定时器队列
+        int shiftBits_;                                  // 时间轮每个槽位所占二进制位数
+        int wheelMask_;                                  // 时间轮大小掩码（用于取模运算）
+        Tick_t curTick_;                                 // 当前时间轮所在位置的 tick 值
+        size_t slotCount_;                               // 已创建的槽位数量
+        std::vector<std::unique_ptr<MinHeap<T>>> slots_; // 每个槽位对应的定时器队列，首次插入时分配，Shrink 时释放
+        std::vector<std::unique_ptr<MinHeap<T>>> spare_; // 缓存的空槽位
+        std::vector<uint64_t> occupied_;                 // 非空槽位位图
     };
 
     template <typename T>
-    TimerWheel<T>::TimerWheel() : shiftBits_(kBitShift), wheelMask_(kWheelSize - 1), curTick_(0) {
-        // 初始化每个槽位为null
-        for (unsigned int i = 0; i < kWheelSize; i++) {
-            slots_.emplace_back(new MinHeap<T>());
+    TimerWheel<T>::TimerWheel() : shiftBits_(kBitShift), wheelMask_(kWheelSize - 1), curTick_(0), slotCount_(0), occupied_((kWheelSize + 63) / 64) {
+    }
+
+    template <typename T>
+    TimerWheel<T>::TimerWheel(int bitShift, int wheelSize) : shiftBits_(bitShift), wheelMask_(wheelSize - 1), curTick_(0), slotCount_(0), occupied_((wheelSize + 63) / 64) {
+    }
+
+    template <typename T>
+    MinHeap<T> &TimerWheel<T>::MaterializeSlot(int slotIndex) {
+        if (slots_.empty()) {
+            slots_.resize(wheelMask_ + 1);
+        }
+        auto &slot = slots_[slotIndex];
+        if (!slot) {
+            if (!spare_.empty()) {
+                slot = std::move(spare_.back());
+                spare_.pop_back();
+            } else {
+                slot.reset(new MinHeap<T>());
+            }
+            slotCount_++;
+            occupied_[slotIndex >> 6] |= uint64_t(1) << (slotIndex & 63);
+        }
+        return *slot;
+    }
+
+    template <typename T>
+    void TimerWheel<T>::ReleaseSlot(int slotIndex) {
+        auto &slot = slots_[slotIndex];
+        if (!slot || !slot->empty()) {
+            return;
         }
+        RecycleSlot(DetachSlot(slotIndex));
     }
 
     template <typename T>
-    TimerWheel<T>::TimerWheel(int bitShift, int wheelSize) : shiftBits_(bitShift), wheelMask_(wheelSize - 1), curTick_(0) {
-        // 初始化每个槽位为null
-        for (int i = 0; i < wheelSize; i++) {
-            slots_.emplace_back(new MinHeap<T>());
+    std::unique_ptr<MinHeap<T>> TimerWheel<T>::DetachSlot(int slotIndex) {
+        slotCount_--;
+        occupied_[slotIndex >> 6] &= ~(uint64_t(1) << (slotIndex & 63));
+        return std::move(slots_[slotIndex]);
+    }
+
+    template <typename T>
+    void TimerWheel<T>::RecycleSlot(std::unique_ptr<MinHeap<T>> slot) {
+        if (spare_.size() < kSpareSlots && slot->capacity() <= kSpareCapacity) {
+            spare_.push_back(std::move(slot));
         }
     }
 
@@ -69,38 +172,105 @@ namespace CTimer {
         // 计算应该放在哪个槽位
         int slotIndex = GetSlotIndex(expire_time);
         // 将定时器放入对应的槽位
-        slots_[slotIndex]->push(task);
+        MaterializeSlot(slotIndex).push(task);
+    }
+
+    template <typename T>
+    void TimerWheel<T>::AddTimer(T &&task) {
+        int slotIndex = GetSlotIndex(task.ExpireTime());
+        MaterializeSlot(slotIndex).push(std::move(task));
+    }
+
+    template <typename T>
+    void TimerWheel<T>::AddTimer(const T &task, Tick_t tick) {
+        MaterializeSlot(GetSlotIndex(tick)).push(task);
+    }
+
+    template <typename T>
+    void TimerWheel<T>::AddTimer(T &&task, Tick_t tick) {
+        MaterializeSlot(GetSlotIndex(tick)).push(std::move(task));
     }
 
     template <typename T>
     void TimerWheel<T>::RemoveTimer(const T &task) {
         Tick_t expire_time = task.ExpireTime();
         int slotIndex = GetSlotIndex(expire_time);
+        if (slots_.empty() || !slots_[slotIndex]) {
+            return;
+        }
         // 从当前槽位中删除
-        auto slot_tasks = slots_[slotIndex];
-
-        slot_tasks->remove(task);
+        slots_[slotIndex]->remove(task);
+        ReleaseSlot(slotIndex);
     }
 
     template <typename T>
     Tick_t TimerWheel<T>::GetEarliestTime() const {
-        if (slots_[curTick_]->empty()) {
+        int slotIndex = NextOccupiedSlot(curTick_);
+        if (slotIndex < 0) {
             return kInvalidTime;
         }
-        return slots_[curTick_]->top().ExpireTime();
+        return GetSlotEarliestTime(slotIndex);
+    }
+
+    template <typename T>
+    int TimerWheel<T>::NextOccupiedSlot(int from) const {
+        if (slotCount_ == 0) {
+            return -1;
+        }
+        int words = occupied_.size();
+        int word = from >> 6;
+        // 第一个字屏蔽 from 之前的槽位，转完一圈回到该字时再包含这些槽位
+        uint64_t bits = occupied_[word] & (~uint64_t(0) << (from & 63));
+        for (int n = 0; n <= words; n++) {
+            if (bits) {
+                return (word << 6) + __builtin_ctzll(bits);
+            }
+            word = word + 1 < words ? word + 1 : 0;
+#ifdef __AVX2__
+            // 大时间轮一次跳过 256 个空槽位
+            while (n + 4 < words && (word & 3) == 0 && word + 4 <= words) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&occupied_[word]));
+                if (!_mm256_testz_si256(block, block)) {
+                    break;
+                }
+                n += 4;
+                word = word + 4 < words ? word + 4 : 0;
+            }
+#endif
+            bits = occupied_[word];
+        }
+        return -1;
+    }
+
+    template <typename T>
+    Tick_t TimerWheel<T>::GetSlotEarliestTime(int slotIndex) const {
+        return slots_[slotIndex]->top().ExpireTime();
+    }
+
+    template <typename T>
+    void TimerWheel<T>::Shrink() {
+        if (slotCount_ != 0) {
+            return;
+        }
+        std::vector<std::unique_ptr<MinHeap<T>>>().swap(slots_);
+        std::vector<std::unique_ptr<MinHeap<T>>>().swap(spare_);
     }
 
     template <typename T>
     void TimerWheel<T>::Tick() {
         std::vector<T> tasks;
         // 取出当前槽位中的队列
-        auto heap = slots_[curTick_];
-        while (!heap->empty()) {
-            auto task = heap->top();
-            if (task.ExpireTime() <= Now()) {
+        if (!slots_.empty() && slots_[curTick_]) {
+            auto &heap = slots_[curTick_];
+            while (!heap->empty()) {
+                auto task = heap->top();
+                if (task.ExpireTime() > Now()) {
+                    break;
+                }
                 tasks.push_back(task);
                 heap->pop();
             }
+            ReleaseSlot(curTick_);
         }
 
         // 处理到期任务
@@ -127,7 +297,16 @@ namespace CTimer {
 
     template <typename T>
     std::vector<MinHeap<T> *> TimerWheel<T>::GetSlots() const {
-        return slots_;
+        std::vector<MinHeap<T> *> slots(wheelMask_ + 1, nullptr);
+        for (size_t i = 0; i < slots_.size(); i++) {
+            slots[i] = slots_[i].get();
+        }
+        return slots;
+    }
+
+    template <typename T>
+    size_t TimerWheel<T>::GetSlotCount() const {
+        return slotCount_;
     }
 
     template <typename T>
@@ -138,11 +317,37 @@ namespace CTimer {
     template <typename T>
     std::vector<T> TimerWheel<T>::GetExpiredTimers(Tick_t expire_time) {
         std::vector<T> tasks;
+        DrainExpired(expire_time, tasks);
+        return tasks;
+    }
+
+    template <typename T>
+    template <typename Visitor>
+    size_t TimerWheel<T>::DrainExpired(Tick_t expire_time, Visitor &&visit) {
         int slotIndex = GetSlotIndex(expire_time);
-        auto slot_tasks = slots_[slotIndex];
+        if (slots_.empty() || !slots_[slotIndex]) {
+            return 0;
+        }
+        // 访问期间插入同一槽位的任务会放入新的槽位
+        auto slot = DetachSlot(slotIndex);
+        size_t count = slot->drain(visit);
+        RecycleSlot(std::move(slot));
+        return count;
+    }
 
-        slot_tasks->traverse([&](auto a) { tasks.push_back(a);slot_tasks->remove(a); });
-        return tasks;
+    template <typename T>
+    template <typename Visitor>
+    size_t TimerWheel<T>::DrainAll(Visitor &&visit) {
+        size_t count = 0;
+        for (int slot = NextOccupiedSlot(0); slot >= 0; slot = NextOccupiedSlot(slot)) {
+            count += DrainExpired(Tick_t(slot) << shiftBits_, visit);
+        }
+        return count;
+    }
+
+    template <typename T>
+    size_t TimerWheel<T>::DrainExpired(Tick_t expire_time, std::vector<T> &buffer) {
+        return DrainExpired(expire_time, [&buffer](T &&task) { buffer.push_back(std::move(task)); });
     }
 
 } // namespace CTimer
@@ -0,0 +1,142 @@
+#ifndef _WHEEL_LAYOUT_H_
+#define _WHEEL_LAYOUT_H_
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <initializer_list>
+
+#include "timer_base.h"
+#include "timer_wheel.h"
+
+namespace CTimer {
+
+    // tick 间隔的有效位数，0 和 1 都视为 1 位
+    inline int TickBitWidth(Tick_t delta) {
+        return 64 - __builtin_clzll(delta | 1);
+    }
+
+    // 计算每层时间轮槽位索引的起始位
+    template <size_t N>
+    constexpr std::array<int, N> MakeWheelShifts(const std::array<int, N> &bits) {
+        std::array<int, N> shifts{};
+        int shift = 0;
+        for (size_t i = 0; i < N; i++) {
+            shifts[i] = shift;
+            shift += bits[i];
+        }
+        return shifts;
+    }
+
+    // 按 tick 间隔的有效位数查找所在层级，超出所有层级时为 levels
+    template <typename Bits>
+    constexpr std::array<uint8_t, 65> MakeLevelTable(const Bits &bits, size_t levels) {
+        std::array<uint8_t, 65> table{};
+        for (int width = 0; width <= 64; width++) {
+            size_t level = 0;
+            int covered = bits[0];
+            while (level < levels && width > covered) {
+                level++;
+                covered += level < levels ? bits[level] : 0;
+            }
+            table[width] = static_cast<uint8_t>(level);
+        }
+        return table;
+    }
+
+    /**
+     * @brief 编译期时间轮布局
+     *
+     * Bits 为每层时间轮占据的二进制位数，层数、起始位和掩码都是编译期常量，
+     * 时间轮存放在 std::array 中，层级选择只需一次 clz 和一次查表
+     */
+    template <int... Bits>
+    class WheelLayout {
+    public:
+        static constexpr size_t kLevels = sizeof...(Bits);
+        static constexpr std::array<int, kLevels> kBits = {{Bits...}};
+        static constexpr std::array<int, kLevels> kShifts = MakeWheelShifts(kBits);
+        static constexpr int kTotalBits = (Bits + ...);
+        static constexpr std::array<uint8_t, 65> kLevelTable = MakeLevelTable(kBits, kLevels);
+
+        static_assert(kLevels > 0, "wheel layout needs at least one level");
+        static_assert(kTotalBits <= 64, "wheel layout cannot exceed 64 bits");
+
+        template <typename E>
+        using Wheels = std::array<TimerWheel<E>, kLevels>;
+
+        constexpr size_t Levels() const { return kLevels; }
+
+        constexpr int Shift(size_t level) const { return kShifts[level]; }
+
+        constexpr int TotalBits() const { return kTotalBits; }
+
+        // 低于该层的 tick 位掩码，为 0 时表示低层时间轮转完一圈
+        constexpr Tick_t LowMask(size_t level) const { return (Tick_t(1) << kShifts[level]) - 1; }
+
+        // 根据距离当前 tick 的间隔选择层级
+        size_t Level(Tick_t delta) const { return kLevelTable[TickBitWidth(delta)]; }
+
+        template <typename E>
+        Wheels<E> MakeWheels() const {
+            return MakeWheels<E>(std::make_index_sequence<kLevels>());
+        }
+
+    private:
+        template <typename E, size_t... I>
+        static Wheels<E> MakeWheels(std::index_sequence<I...>) {
+            return {{TimerWheel<E>(kShifts[I], 1 << kBits[I])...}};
+        }
+    };
+
+    // 32位tick：8 6 6 6 6
+    using WheelLayout32 = WheelLayout<8, 6, 6, 6, 6>;
+
+    // 64位tick：8 6 6 6 6 6 6 6 6 8
+    using WheelLayout64 = WheelLayout<8, 6, 6, 6, 6, 6, 6, 6, 6, 8>;
+
+    // 运行期配置的时间轮布局
+    class RuntimeWheelLayout {
+    public:
+        RuntimeWheelLayout(const std::vector<int> &bits = {8, 6, 6, 6, 6})
+            : bits_(bits), totalBits_(0) {
+            for (size_t i = 0; i < bits_.size(); i++) {
+                shifts_.push_back(totalBits_);
+                totalBits_ += bits_[i];
+            }
+            levelTable_ = MakeLevelTable(bits_, bits_.size());
+        }
+
+        RuntimeWheelLayout(std::initializer_list<int> bits) : RuntimeWheelLayout(std::vector<int>(bits)) {}
+
+        template <typename E>
+        using Wheels = std::vector<TimerWheel<E>>;
+
+        size_t Levels() const { return bits_.size(); }
+
+        int Shift(size_t level) const { return shifts_[level]; }
+
+        int TotalBits() const { return totalBits_; }
+
+        Tick_t LowMask(size_t level) const { return (Tick_t(1) << shifts_[level]) - 1; }
+
+        size_t Level(Tick_t delta) const { return levelTable_[TickBitWidth(delta)]; }
+
+        template <typename E>
+        Wheels<E> MakeWheels() const {
+            Wheels<E> wheels;
+            for (size_t i = 0; i < bits_.size(); i++) {
+                wheels.push_back(TimerWheel<E>(shifts_[i], 1 << bits_[i]));
+            }
+            return wheels;
+        }
+
+    private:
+        std::vector<int> bits_;                // 每个时间轮占据的二进制位数
+        std::vector<int> shifts_;              // 每个时间轮槽位索引的起始位
+        int totalBits_;                        // 所有时间轮占据的二进制位数之和
+        std::array<uint8_t, 65> levelTable_{}; // 有效位数到层级的映射
+    };
+} // namespace CTimer
+
+#endif /* _WHEEL_LAYOUT_H_ */
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "debouncer.h"
+#include "throttler.h"
+#include <thread>
+
+TEST(testComp, testDebouncer) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    CTimer::Debouncer<CTimer::TimerTask> debouncer(timer, 30, [&fired]() { fired++; });
+
+    timer.Start();
+    // 连续触发 200ms，期间不执行
+    auto end = CTimer::AddMilliSeconds(200);
+    while (CTimer::Now() < end) {
+        debouncer.Trigger();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    EXPECT_EQ(fired, 0);
+    EXPECT_TRUE(debouncer.Pending());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(debouncer.Pending());
+
+    // 执行后可以再次触发
+    debouncer.Trigger();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_EQ(fired, 2);
+}
+
+TEST(testComp, testThrottler) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    CTimer::Throttler<CTimer::TimerTask> throttler(timer, 50, [&fired]() { fired++; });
+
+    timer.Start();
+    // 持续触发 500ms，每 50ms 最多执行一次
+    auto end = CTimer::AddMilliSeconds(500);
+    while (CTimer::Now() < end) {
+        throttler.Trigger();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_GE(fired, 8);
+    EXPECT_LE(fired, 11);
+    EXPECT_FALSE(throttler.Pending());
+}
+
+TEST(testComp, testSkipListOverflow) {
+    // 使用跳表作为溢出存储的定时器
+    typedef CTimer::TimerSkipList<CTimer::TimerEntry<CTimer::TimerTask>> Overflow;
+    CTimer::Timer<CTimer::TimerTask, CTimer::RuntimeWheelLayout, Overflow> timer(std::chrono::milliseconds(1), {4, 2});
+    std::atomic<int> debounced(0), throttled(0);
+    CTimer::Debouncer<CTimer::TimerTask, CTimer::RuntimeWheelLayout, Overflow> debouncer(timer, 100, [&debounced]() { debounced++; });
+    CTimer::Throttler<CTimer::TimerTask, CTimer::RuntimeWheelLayout, Overflow> throttler(timer, 100, [&throttled]() { throttled++; });
+
+    timer.Start();
+    debouncer.Trigger();
+    throttler.Trigger();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    timer.Stop();
+    EXPECT_EQ(debounced, 1);
+    EXPECT_EQ(throttled, 1);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "shm_timer.h"
+#include <sys/wait.h>
+#include <thread>
+
+namespace {
+    std::string ServiceName(const char *tag) { return std::string(tag) + "." + std::to_string(getpid()); }
+
+    // 等待并读取到期通知，直到收到 count 个或超时
+    std::vector<CTimer::ShmTimerExpiry> Collect(CTimer::ShmTimerClient &client, size_t count, int timeout) {
+        std::vector<CTimer::ShmTimerExpiry> expired;
+        auto deadline = CTimer::Now() + timeout;
+        while (expired.size() < count && CTimer::Now() < deadline) {
+            client.Wait(static_cast<int>(deadline - CTimer::Now()));
+            client.Poll([&expired](const CTimer::ShmTimerExpiry &expiry) { expired.push_back(expiry); });
+        }
+        return expired;
+    }
+} // namespace
+
+TEST(testComp, testShmRing) {
+    std::unique_ptr<CTimer::ShmRing<int, 4>> ring(new CTimer::ShmRing<int, 4>());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring->Push(i));
+    }
+    EXPECT_FALSE(ring->Push(4));
+    int value;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring->Pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring->Pop(value));
+    EXPECT_TRUE(ring->Empty());
+}
+
+TEST(testComp, testShmTimer) {
+    CTimer::ShmTimerService service(ServiceName("test"));
+    ASSERT_TRUE(service.Start());
+
+    CTimer::ShmTimerClient client(ServiceName("test"));
+    ASSERT_TRUE(client.Connect());
+
+    auto start = CTimer::Now();
+    uint64_t first = client.AddTimer(start + 30);
+    uint64_t second = client.AddTimer(start + 60);
+    uint64_t cancelled = client.AddTimer(start + 90);
+    EXPECT_TRUE(client.Cancel(cancelled));
+
+    // 到期通知按执行顺序到达，已取消的任务不会到期
+    auto expired = Collect(client, 3, 300);
+    ASSERT_EQ(expired.size(), 2u);
+    EXPECT_EQ(expired[0].id, first);
+    EXPECT_EQ(expired[1].id, second);
+    EXPECT_GE(expired[0].fireTime, (start + 30) * 1000);
+    EXPECT_GE(expired[1].fireTime, (start + 60) * 1000);
+
+    // 周期任务
+    uint64_t periodic = client.AddTimer(CTimer::AddMilliSeconds(10), 10);
+    expired = Collect(client, 5, 500);
+    ASSERT_EQ(expired.size(), 5u);
+    for (auto &expiry : expired) {
+        EXPECT_EQ(expiry.id, periodic);
+    }
+    client.Cancel(periodic);
+
+    EXPECT_EQ(service.Clients(), 1u);
+    client.Close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(service.Clients(), 0u);
+    service.Stop();
+
+    // 服务停止后无法连接
+    CTimer::ShmTimerClient late(ServiceName("test"));
+    EXPECT_FALSE(late.Connect());
+}
+
+TEST(testComp, testShmTimerSingleInstance) {
+    CTimer::ShmTimerService service(ServiceName("single"));
+    ASSERT_TRUE(service.Start());
+
+    // 同名的第二个服务启动失败，不影响正在运行的服务
+    {
+        CTimer::ShmTimerService duplicate(ServiceName("single"));
+        EXPECT_FALSE(duplicate.Start());
+    }
+    CTimer::ShmTimerClient client(ServiceName("single"));
+    ASSERT_TRUE(client.Connect());
+    uint64_t id = client.AddTimer(CTimer::AddMilliSeconds(10));
+    auto expired = Collect(client, 1, 300);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0].id, id);
+}
+
+TEST(testComp, testShmTimerProcesses) {
+    std::string name = ServiceName("fork");
+    CTimer::ShmTimerService service(name);
+    ASSERT_TRUE(service.Start());
+
+    // 多个子进程共用服务进程的定时器
+    std::vector<pid_t> children;
+    for (int i = 0; i < 3; i++) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            CTimer::ShmTimerClient client(name);
+            if (!client.Connect()) {
+                _exit(2);
+            }
+            for (int j = 1; j <= 20; j++) {
+                client.AddTimer(CTimer::AddMilliSeconds(j * 5));
+            }
+            auto expired = Collect(client, 20, 1000);
+            _exit(expired.size() == 20 ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(service.Clients(), 0u);
+}
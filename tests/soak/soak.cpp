@@ -0,0 +1,382 @@
+/**
+ * @brief 定时器长时间压测
+ *
+ * 多个生产者线程按突发的泊松到达添加定时任务，超时时间服从指数分布，
+ * 大部分任务在到期前取消，少量任务在到期前延后。定期输出吞吐、RSS、
+ * 执行延迟分位数以及漏执行和重复执行的数量。
+ *
+ * 用法：soak --duration=300 --producers=4 --rate=50000 --timeout=2000 --cancel=0.9 --precision=1 --budget=1000
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "timer.h"
+
+namespace {
+
+    struct Options {
+        int duration = 60;       // 压测时长（秒）
+        int producers = 4;       // 生产者线程数
+        double rate = 20000;     // 每个生产者平均每秒添加的任务数
+        double timeout = 1000;   // 平均超时时间（毫秒）
+        double cancel = 0.9;     // 取消比例
+        double reschedule = 0.05; // 延后比例
+        double burst = 4;        // 突发期速率倍数
+        int resolution = 1000;   // 时间粒度（微秒）
+        int grace = 1000;        // 判定漏执行的宽限时间（毫秒）
+        int report = 10;         // 输出间隔（秒）
+        int precision = 0;       // 是否开启精确模式
+        int budget = 0;          // 每轮最多执行的任务数，0 表示不限
+    };
+
+    // 单个定时任务的记录
+    struct Probe {
+        std::atomic<CTimer::Tick_t> deadline; // 到期时间（微秒）
+        std::atomic<int> fired{0};            // 执行次数
+        std::atomic<bool> cancelled{false};   // 是否已取消
+        CTimer::Tick_t checkAt = 0;           // 登记的检查时间（微秒），由 Auditor 的锁保护，0 表示未登记
+        CTimer::TimerId id;
+    };
+
+    // 执行延迟直方图，前 1ms 按 10us 分桶，之后按 1ms 分桶
+    class LatencyHistogram {
+    public:
+        static const int kFineBuckets = 100;
+        static const int kCoarseBuckets = 10000;
+
+        LatencyHistogram() : buckets_(kFineBuckets + kCoarseBuckets + 1) {}
+
+        void Record(int64_t late) {
+            size_t index;
+            if (late < 0) {
+                early_++;
+                index = 0;
+            } else if (late < 1000) {
+                index = late / 10;
+            } else {
+                index = std::min<int64_t>(kFineBuckets + late / 1000, kFineBuckets + kCoarseBuckets);
+            }
+            buckets_[index].fetch_add(1, std::memory_order_relaxed);
+            int64_t max = max_.load(std::memory_order_relaxed);
+            while (late > max && !max_.compare_exchange_weak(max, late)) {
+            }
+        }
+
+        // 分位数的上界（微秒）
+        int64_t Percentile(double p) const {
+            uint64_t total = 0;
+            for (auto &bucket : buckets_) {
+                total += bucket.load(std::memory_order_relaxed);
+            }
+            if (total == 0) {
+                return 0;
+            }
+            uint64_t target = static_cast<uint64_t>(total * p), count = 0;
+            for (size_t i = 0; i < buckets_.size(); i++) {
+                count += buckets_[i].load(std::memory_order_relaxed);
+                if (count > target) {
+                    return i < kFineBuckets ? (i + 1) * 10 : (i - kFineBuckets + 1) * 1000;
+                }
+            }
+            return max_;
+        }
+
+        int64_t Max() const { return max_; }
+
+        uint64_t Early() const { return early_; }
+
+    private:
+        std::vector<std::atomic<uint64_t>> buckets_;
+        std::atomic<int64_t> max_{0};
+        std::atomic<uint64_t> early_{0};
+    };
+
+    struct Stats {
+        std::atomic<uint64_t> added{0};
+        std::atomic<uint64_t> cancelled{0};
+        std::atomic<uint64_t> rescheduled{0};
+        std::atomic<uint64_t> fired{0};
+        std::atomic<uint64_t> missed{0};
+        std::atomic<uint64_t> duplicated{0};
+        std::atomic<uint64_t> cancelledFired{0};
+        LatencyHistogram latency;
+    };
+
+    // 按检查时间分桶保存任务记录，到期后检查是否漏执行或重复执行
+    class Auditor {
+    public:
+        Auditor(Stats &stats, CTimer::Tick_t grace) : stats_(stats), grace_(grace) {}
+
+        // 延后的任务只按最后一次登记的检查时间检查，同一秒内不重复登记
+        void Track(const std::shared_ptr<Probe> &probe, CTimer::Tick_t checkAt) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool tracked = probe->checkAt != 0 && probe->checkAt / 1000000 == checkAt / 1000000;
+            probe->checkAt = checkAt;
+            if (!tracked) {
+                pending_[checkAt / 1000000].push_back(probe);
+            }
+        }
+
+        void Check(CTimer::Tick_t now) {
+            std::vector<std::shared_ptr<Probe>> due;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // 只检查已经完整过去的秒
+                auto end = pending_.lower_bound(now / 1000000);
+                for (auto it = pending_.begin(); it != end; ++it) {
+                    for (auto &probe : it->second) {
+                        // 跳过已重新登记到其他秒的旧记录
+                        if (probe->checkAt / 1000000 == it->first) {
+                            probe->checkAt = 0;
+                            due.push_back(probe);
+                        }
+                    }
+                }
+                pending_.erase(pending_.begin(), end);
+            }
+            for (auto &probe : due) {
+                // 正在延后的任务随后会按新的到期时间重新登记
+                if (probe->deadline.load() + grace_ > now && !probe->cancelled) {
+                    continue;
+                }
+                int fired = probe->fired.load();
+                if (probe->cancelled) {
+                    stats_.cancelledFired += fired > 0;
+                } else if (fired == 0) {
+                    stats_.missed++;
+                }
+                stats_.duplicated += fired > 1;
+            }
+        }
+
+        size_t Pending() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t count = 0;
+            for (auto &bucket : pending_) {
+                count += bucket.second.size();
+            }
+            return count;
+        }
+
+    private:
+        Stats &stats_;
+        CTimer::Tick_t grace_; // 宽限时间（微秒）
+        std::mutex mutex_;
+        std::map<CTimer::Tick_t, std::vector<std::shared_ptr<Probe>>> pending_;
+    };
+
+    // 生产者待执行的取消或延后操作
+    struct Action {
+        CTimer::Tick_t at;
+        bool cancel;
+        std::shared_ptr<Probe> probe;
+
+        bool operator>(const Action &other) const { return at > other.at; }
+    };
+
+    size_t ResidentBytes() {
+        long pages = 0, resident = 0;
+        FILE *f = fopen("/proc/self/statm", "r");
+        if (f) {
+            if (fscanf(f, "%ld %ld", &pages, &resident) != 2) {
+                resident = 0;
+            }
+            fclose(f);
+        }
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+
+    bool ParseOption(const char *arg, const char *name, double &value) {
+        size_t len = strlen(name);
+        if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, len) != 0 || arg[2 + len] != '=') {
+            return false;
+        }
+        value = atof(arg + 3 + len);
+        return true;
+    }
+
+    Options ParseOptions(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            double value;
+            if (ParseOption(argv[i], "duration", value)) {
+                options.duration = value;
+            } else if (ParseOption(argv[i], "producers", value)) {
+                options.producers = value;
+            } else if (ParseOption(argv[i], "rate", value)) {
+                options.rate = value;
+            } else if (ParseOption(argv[i], "timeout", value)) {
+                options.timeout = value;
+            } else if (ParseOption(argv[i], "cancel", value)) {
+                options.cancel = value;
+            } else if (ParseOption(argv[i], "reschedule", value)) {
+                options.reschedule = value;
+            } else if (ParseOption(argv[i], "burst", value)) {
+                options.burst = value;
+            } else if (ParseOption(argv[i], "resolution", value)) {
+                options.resolution = value;
+            } else if (ParseOption(argv[i], "grace", value)) {
+                options.grace = value;
+            } else if (ParseOption(argv[i], "report", value)) {
+                options.report = value;
+            } else if (ParseOption(argv[i], "precision", value)) {
+                options.precision = value;
+            } else if (ParseOption(argv[i], "budget", value)) {
+                options.budget = value;
+            } else {
+                fprintf(stderr, "unknown option: %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        return options;
+    }
+
+    void Produce(CTimer::Timer<CTimer::TimerTask> &timer, const Options &options, Stats &stats, Auditor &auditor,
+                 std::atomic<bool> &quit, unsigned seed) {
+        std::mt19937_64 rng(seed);
+        std::exponential_distribution<double> timeoutDist(1.0 / options.timeout);
+        std::uniform_real_distribution<double> uniform(0, 1);
+        std::priority_queue<Action, std::vector<Action>, std::greater<Action>> actions;
+
+        // 每秒前 20% 为突发期，突发期速率为平均速率的 burst 倍，其余时间降低速率保持平均值不变
+        const double burstShare = 0.2;
+        double burst = std::min(options.burst, 1 / burstShare);
+        double onRate = options.rate * burst;
+        double offRate = options.rate * (1 - burstShare * burst) / (1 - burstShare);
+
+        CTimer::Tick_t start = CTimer::NowMicro();
+        double issued = 0;
+        while (!quit) {
+            CTimer::Tick_t now = CTimer::NowMicro();
+            double elapsed = (now - start) / 1e6;
+            double whole = static_cast<int64_t>(elapsed);
+            double inSecond = elapsed - whole;
+            double expected = whole * options.rate +
+                              std::min(inSecond, burstShare) * onRate + std::max(inSecond - burstShare, 0.0) * offRate;
+
+            for (; issued < expected; issued++) {
+                auto probe = std::make_shared<Probe>();
+                double timeout = timeoutDist(rng);
+                CTimer::Tick_t deadline = now + static_cast<CTimer::Tick_t>(timeout * 1000);
+                probe->deadline = deadline;
+                Stats *s = &stats;
+                // 检查完成后记录即被释放，此后的执行不再统计
+                std::weak_ptr<Probe> weak = probe;
+                probe->id = timer.AddTimer(CTimer::TimerTask((deadline + 999) / 1000, [s, weak]() {
+                    auto p = weak.lock();
+                    if (!p) {
+                        return;
+                    }
+                    s->latency.Record(static_cast<int64_t>(CTimer::NowMicro()) - static_cast<int64_t>(p->deadline.load()));
+                    s->fired++;
+                    p->fired++;
+                }));
+                stats.added++;
+
+                double roll = uniform(rng);
+                if (roll < options.cancel) {
+                    actions.push({now + static_cast<CTimer::Tick_t>(timeout * 1000 * uniform(rng) * 0.9), true, probe});
+                } else if (roll < options.cancel + options.reschedule) {
+                    actions.push({now + static_cast<CTimer::Tick_t>(timeout * 1000 * uniform(rng) * 0.9), false, probe});
+                }
+                auditor.Track(probe, deadline + options.grace * 1000);
+            }
+
+            while (!actions.empty() && actions.top().at <= now) {
+                Action action = actions.top();
+                actions.pop();
+                if (action.cancel) {
+                    action.probe->cancelled = true;
+                    timer.Cancel(action.probe->id);
+                    stats.cancelled++;
+                } else if (action.probe->id.Node()->Deadline() != CTimer::kIdleDeadline) {
+                    // 已到期的任务即使回调尚未执行，再延后也会重新激活，不计入
+                    CTimer::Tick_t deadline = action.probe->deadline + static_cast<CTimer::Tick_t>(timeoutDist(rng) * 1000);
+                    action.probe->deadline = deadline;
+                    timer.Reschedule(action.probe->id, (deadline + 999) / 1000);
+                    auditor.Track(action.probe, deadline + options.grace * 1000);
+                    stats.rescheduled++;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    void Report(const char *tag, double seconds, double active, Stats &stats, Auditor &auditor, size_t baseRss) {
+        long long growth = static_cast<long long>(ResidentBytes()) - static_cast<long long>(baseRss);
+        printf("[%s] t=%.0fs added=%lu (%.0f/s) cancelled=%lu rescheduled=%lu fired=%lu "
+               "late(us) p50=%ld p90=%ld p99=%ld p999=%ld max=%ld early=%lu "
+               "missed=%lu duplicated=%lu cancelled_fired=%lu tracking=%zu rss_growth=%lldKB\n",
+               tag, seconds, stats.added.load(), stats.added / std::max(active, 1.0), stats.cancelled.load(),
+               stats.rescheduled.load(), stats.fired.load(), stats.latency.Percentile(0.5), stats.latency.Percentile(0.9),
+               stats.latency.Percentile(0.99), stats.latency.Percentile(0.999), stats.latency.Max(), stats.latency.Early(),
+               stats.missed.load(), stats.duplicated.load(), stats.cancelledFired.load(), auditor.Pending(), growth / 1024);
+        fflush(stdout);
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options = ParseOptions(argc, argv);
+    printf("soak: duration=%ds producers=%d rate=%.0f/s timeout=%.0fms cancel=%.2f reschedule=%.2f burst=%.1f resolution=%dus\n",
+           options.duration, options.producers, options.rate, options.timeout, options.cancel, options.reschedule,
+           options.burst, options.resolution);
+
+    Stats stats;
+    Auditor auditor(stats, options.grace * 1000);
+    CTimer::Timer<CTimer::TimerTask> timer{std::chrono::microseconds(options.resolution)};
+    timer.SetPrecision(options.precision != 0);
+    timer.SetWorkBudget(options.budget, 0);
+    timer.Start();
+    size_t baseRss = ResidentBytes();
+
+    std::atomic<bool> quit(false);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < options.producers; i++) {
+        producers.emplace_back(Produce, std::ref(timer), std::cref(options), std::ref(stats), std::ref(auditor), std::ref(quit), i + 1);
+    }
+
+    CTimer::Tick_t start = CTimer::NowMicro();
+    CTimer::Tick_t end = start + options.duration * 1000000ull;
+    CTimer::Tick_t nextReport = start + options.report * 1000000ull;
+    while (CTimer::NowMicro() < end) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CTimer::Tick_t now = CTimer::NowMicro();
+        auditor.Check(now);
+        if (now >= nextReport) {
+            Report("soak", (now - start) / 1e6, (now - start) / 1e6, stats, auditor, baseRss);
+            nextReport += options.report * 1000000ull;
+        }
+    }
+
+    quit = true;
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    // 等待剩余任务到期后完成检查
+    CTimer::Tick_t drainEnd = CTimer::NowMicro() + (options.timeout * 10 + options.grace) * 1000;
+    while (auditor.Pending() > 0 && CTimer::NowMicro() < drainEnd) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auditor.Check(CTimer::NowMicro());
+    }
+    timer.Stop();
+    Report("done", (CTimer::NowMicro() - start) / 1e6, options.duration, stats, auditor, baseRss);
+    CTimer::TimerStats timerStats = timer.GetStats();
+    printf("[timer] wakeups=%lu notifies=%lu expired=%lu precision=%d spin=%luus sleep_latency=%luus max_sleep_latency=%luus "
+           "backend=%d migrations=%lu backlog=%lu max_backlog=%lu carryovers=%lu max_carryover_late=%luus\n",
+           timerStats.wakeups, timerStats.notifies, timerStats.expired, timerStats.precision, timerStats.spinThreshold,
+           timerStats.sleepLatency, timerStats.maxSleepLatency, timerStats.backend, timerStats.migrations, timerStats.backlog,
+           timerStats.maxBacklog, timerStats.carryovers, timerStats.maxCarryoverLateness);
+    return stats.missed > 0 || stats.duplicated > 0 ? 1 : 0;
+}
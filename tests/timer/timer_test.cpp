@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "timer.h"
 #include <thread>
+#include <algorithm>
 
 TEST(testComp, testComp1) {
     auto timer = CTimer::Timer<CTimer::TimerTask>();
@@ -13,3 +14,470 @@ TEST(testComp, testComp1) {
         timer.AddTimer(task);
     }
 }
+
+TEST(testComp, testResolution) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::microseconds(10));
+    EXPECT_EQ(timer.GetResolution(), CTimer::kMinResolution);
+
+    auto coarse = CTimer::Timer<CTimer::TimerTask>(std::chrono::seconds(10));
+    EXPECT_EQ(coarse.GetResolution(), CTimer::kMaxResolution);
+
+    // 到期时间向上取整到 tick
+    auto fine = CTimer::Timer<CTimer::TimerTask>(std::chrono::microseconds(500));
+    EXPECT_EQ(fine.ToTick(1000), 2000u);
+    EXPECT_EQ(coarse.ToTick(1001), 2u);
+}
+
+TEST(testComp, testExpire) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1), {8, 6, 6, 6, 6});
+    std::atomic<int> fired(0);
+    std::atomic<CTimer::Tick_t> lastFired(0);
+
+    timer.SetAdaptive(false);
+    timer.Start();
+    for (int i = 1; i <= 5; i++) {
+        auto expire = CTimer::AddMilliSeconds(i * 100);
+        timer.AddTimer(CTimer::TimerTask(expire, [&fired, &lastFired, expire]() {
+            EXPECT_GE(CTimer::Now(), expire);
+            lastFired = expire;
+            fired++;
+        }));
+    }
+    // 超过第一层时间轮范围的任务需要经过高层时间轮降级
+    timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(600), [&fired]() { fired++; }));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    timer.Stop();
+    EXPECT_EQ(fired, 6);
+}
+
+TEST(testComp, testOverflow) {
+    // 时间轮只覆盖 64 个 tick，更远的任务先进入最小堆
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1), {4, 2});
+    std::atomic<int> fired(0);
+
+    timer.SetAdaptive(false);
+    timer.Start();
+    for (int i = 1; i <= 4; i++) {
+        auto expire = CTimer::AddMilliSeconds(i * 50);
+        timer.AddTimer(CTimer::TimerTask(expire, [&fired, expire]() {
+            EXPECT_GE(CTimer::Now(), expire);
+            fired++;
+        }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    timer.Stop();
+    EXPECT_EQ(fired, 4);
+}
+
+TEST(testComp, testWheelLayout) {
+    using Layout = CTimer::WheelLayout32;
+    static_assert(Layout::kLevels == 5, "");
+    static_assert(Layout::kShifts[4] == 26, "");
+    static_assert(Layout::kTotalBits == 32, "");
+    static_assert(CTimer::WheelLayout64::kTotalBits == 64, "");
+
+    // 编译期布局与运行期布局的层级选择一致
+    CTimer::RuntimeWheelLayout runtime({8, 6, 6, 6, 6});
+    Layout layout;
+    for (CTimer::Tick_t delta : {0ull, 1ull, 255ull, 256ull, 16383ull, 16384ull, (1ull << 32) - 1, 1ull << 32}) {
+        EXPECT_EQ(layout.Level(delta), runtime.Level(delta));
+    }
+    EXPECT_EQ(layout.Level(255), 0u);
+    EXPECT_EQ(layout.Level(256), 1u);
+    EXPECT_EQ(layout.Level(1ull << 32), 5u);
+    EXPECT_EQ(CTimer::WheelLayout64().Level(~0ull), 9u);
+}
+
+TEST(testComp, testStaticLayout) {
+    auto timer = CTimer::Timer<CTimer::TimerTask, CTimer::WheelLayout<4, 2>>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+
+    timer.SetAdaptive(false);
+    timer.Start();
+    for (int i = 1; i <= 4; i++) {
+        timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(i * 50), [&fired]() { fired++; }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    timer.Stop();
+    EXPECT_EQ(fired, 4);
+}
+
+TEST(testComp, testCancelGroup) {
+    // 时间轮只覆盖 64 个 tick，大部分分组任务不加锁放入溢出存储
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1), {4, 2});
+    std::atomic<int> fired(0);
+    CTimer::TimerGroup group;
+
+    timer.Start();
+    for (int i = 1; i <= 10; i++) {
+        timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(i * 20), [&fired]() { fired += 100; }), group);
+    }
+    // 超出时间轮范围的分组任务同样可以取消
+    timer.AddTimer(CTimer::TimerTask(CTimer::Now() + 365ull * 24 * 3600 * 1000, [&fired]() { fired += 100; }), group);
+    timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(50), [&fired]() { fired++; }));
+    EXPECT_EQ(group.Size(), 11u);
+
+    EXPECT_EQ(group.CancelGroup(), 11u);
+    EXPECT_EQ(group.Size(), 0u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    timer.Stop();
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(testComp, testCancelRelease) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    CTimer::TimerGroup group;
+    auto token = std::make_shared<int>(0);
+
+    for (int i = 0; i < 1000; i++) {
+        timer.AddTimer(CTimer::TimerTask(CTimer::AddHours(1), [token]() {}), group);
+    }
+    auto single = timer.AddTimer(CTimer::TimerTask(CTimer::AddHours(1), [token]() {}));
+    EXPECT_EQ(token.use_count(), 1002);
+    EXPECT_EQ(timer.GetStats().population, 1001u);
+
+    // 取消后回调捕获的资源立即释放，不必等到原到期时间
+    EXPECT_EQ(group.CancelGroup(), 1000u);
+    EXPECT_EQ(token.use_count(), 2);
+    EXPECT_TRUE(timer.Cancel(single));
+    EXPECT_FALSE(timer.Cancel(single));
+    EXPECT_EQ(token.use_count(), 1);
+
+    // 定时器线程醒来后清理失效任务项
+    std::atomic<int> fired(0);
+    timer.Start();
+    timer.Schedule(10, [&fired]() { fired++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(timer.GetStats().population, 0u);
+}
+
+TEST(testComp, testReschedule) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    std::atomic<CTimer::Tick_t> firedAt(0);
+
+    timer.Start();
+    auto start = CTimer::Now();
+    auto id = timer.AddTimer(CTimer::TimerTask(start + 50, [&]() { firedAt = CTimer::Now(); fired++; }));
+
+    // 多次延后只更新到期时间，最终按最后一次的到期时间执行
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_TRUE(timer.Reschedule(id, start + 50 + i * 10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(firedAt, start + 150);
+
+    // 已执行的任务可以重新激活
+    EXPECT_TRUE(timer.Reschedule(id, CTimer::AddMilliSeconds(20)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired, 2);
+
+    // 提前到期时间
+    start = CTimer::Now();
+    EXPECT_TRUE(timer.Reschedule(id, start + 10000));
+    EXPECT_TRUE(timer.Reschedule(id, start + 30));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired, 3);
+
+    EXPECT_TRUE(timer.Reschedule(id, CTimer::AddMilliSeconds(30)));
+    EXPECT_TRUE(timer.Cancel(id));
+    EXPECT_FALSE(timer.Reschedule(id, CTimer::AddMilliSeconds(30)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(testComp, testPeriodic) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    CTimer::TimerGroup group;
+
+    timer.Start();
+    timer.AddTimer(CTimer::TimerTask(20, CTimer::AddMilliSeconds(20), [&fired]() { fired++; }), group);
+    std::this_thread::sleep_for(std::chrono::milliseconds(210));
+    group.CancelGroup();
+    int count = fired;
+    EXPECT_GE(count, 8);
+    EXPECT_LE(count, 11);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_EQ(fired, count);
+}
+
+TEST(testComp, testFineResolution) {
+    // 100us 粒度下跨越多层时间轮的任务按时执行
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::microseconds(100));
+    std::atomic<int> fired(0);
+    std::atomic<CTimer::Tick_t> maxLate(0);
+
+    timer.SetAdaptive(false);
+    timer.Start();
+    for (int delay : {5, 30, 120, 700}) {
+        auto expire = CTimer::AddMilliSeconds(delay);
+        timer.AddTimer(CTimer::TimerTask(expire, [&fired, &maxLate, expire]() {
+            CTimer::Tick_t late = CTimer::NowMicro() - expire * 1000;
+            if (late > maxLate) {
+                maxLate = late;
+            }
+            fired++;
+        }));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(900));
+    timer.Stop();
+    EXPECT_EQ(fired, 4);
+    EXPECT_LT(maxLate, 5000u);
+}
+
+namespace {
+    // 记录复制次数的回调
+    struct CopyCounter {
+        std::atomic<int> *copies;
+        std::atomic<int> *fired;
+
+        CopyCounter(std::atomic<int> *c, std::atomic<int> *f) : copies(c), fired(f) {}
+        CopyCounter(const CopyCounter &other) : copies(other.copies), fired(other.fired) { (*copies)++; }
+        CopyCounter(CopyCounter &&other) = default;
+
+        void operator()() const { (*fired)++; }
+    };
+} // namespace
+
+TEST(testComp, testEmplace) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> copies(0), fired(0);
+    CTimer::TimerGroup group;
+
+    timer.Start();
+    // 插入过程中只移动回调，不复制
+    timer.Schedule(10, CopyCounter(&copies, &fired));
+    timer.EmplaceTimer(20, CopyCounter(&copies, &fired));
+    timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(30), CopyCounter(&copies, &fired)));
+    timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(40), CopyCounter(&copies, &fired)), group);
+    // 超出时间轮范围的任务经过最小堆
+    auto small = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1), CTimer::RuntimeWheelLayout{4, 2});
+    small.Start();
+    small.Schedule(100, CopyCounter(&copies, &fired));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    timer.Stop();
+    small.Stop();
+    EXPECT_EQ(fired, 5);
+    EXPECT_EQ(copies, 0);
+}
+
+TEST(testComp, testNotifyEarlier) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    std::atomic<CTimer::Tick_t> firedAt(0);
+
+    timer.Start();
+    // 晚于唤醒时间的任务不唤醒定时器线程，早于唤醒时间的任务立即生效
+    timer.Schedule(500, [&fired]() { fired++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    timer.Schedule(800, [&fired]() { fired++; });
+    auto expire = CTimer::AddMilliSeconds(30);
+    timer.AddTimer(CTimer::TimerTask(expire, [&fired, &firedAt]() { firedAt = CTimer::Now(); fired++; }));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(firedAt, expire);
+    EXPECT_LT(firedAt, expire + 20);
+    timer.Stop();
+}
+
+TEST(testComp, testPrecision) {
+    // 单核且有其他负载时定时器线程偶尔被抢占数毫秒，与精确模式无关，
+    // 因此最多重复 5 轮，要求其中一轮全部 20 个任务的执行延迟都在 1 毫秒内
+    CTimer::Tick_t maxLate = 0;
+    for (int attempt = 0; attempt < 5; attempt++) {
+        auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::microseconds(100));
+        std::atomic<int> fired(0);
+        std::atomic<CTimer::Tick_t> late(0);
+
+        timer.SetPrecision(true);
+        timer.Start();
+        for (int i = 1; i <= 20; i++) {
+            auto expire = CTimer::AddMilliSeconds(i * 10);
+            timer.AddTimer(CTimer::TimerTask(expire, [&fired, &late, expire]() {
+                CTimer::Tick_t now = CTimer::NowMicro() - expire * 1000;
+                if (now > late) {
+                    late = now;
+                }
+                fired++;
+            }));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        timer.Stop();
+        auto stats = timer.GetStats();
+        EXPECT_EQ(fired, 20);
+        EXPECT_EQ(stats.expired, 20u);
+        EXPECT_TRUE(stats.precision);
+        EXPECT_GE(stats.wakeups, 20u);
+        EXPECT_GE(stats.spinThreshold, CTimer::kMinSpin);
+        EXPECT_LE(stats.spinThreshold, CTimer::kMaxSpin);
+        maxLate = late;
+        std::cout << "precision: attempt " << attempt << ", max late " << maxLate << "us, spin " << stats.spinThreshold
+                  << "us, sleep latency " << stats.sleepLatency << "us" << std::endl;
+        if (maxLate < 1000) {
+            break;
+        }
+    }
+    // 自旋结束时已到唤醒时间，执行延迟只包含处理开销
+    EXPECT_LT(maxLate, 1000u);
+}
+
+TEST(testComp, testPrecisionNotify) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::microseconds(100));
+    std::atomic<int> fired(0);
+
+    timer.SetPrecision(true);
+    timer.Start();
+    for (int i = 1; i <= 50; i++) {
+        timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(i * 4), [&fired]() { fired++; }));
+    }
+    // 精确睡眠期间添加的更晚任务同样不唤醒定时器线程
+    int added = 0;
+    auto end = CTimer::AddMilliSeconds(200);
+    while (CTimer::Now() < end) {
+        timer.AddTimer(CTimer::TimerTask(CTimer::AddSeconds(10), []() {}));
+        added++;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    timer.Stop();
+    auto stats = timer.GetStats();
+    EXPECT_EQ(fired, 50);
+    EXPECT_LT(stats.notifies, uint64_t(added / 20));
+    std::cout << "precision notify: added " << added << ", notifies " << stats.notifies << std::endl;
+}
+
+TEST(testComp, testAdaptive) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    std::atomic<int> fired(0);
+    auto add = [&](int count, int delay) {
+        for (int i = 0; i < count; i++) {
+            timer.Schedule(delay + i % 50, [&fired]() { fired++; });
+        }
+    };
+
+    // 按任务数依次切换到最小堆和时间轮
+    add(CTimer::kSmallTimers, 100);
+    EXPECT_EQ(timer.GetStats().backend, CTimer::kSmallBackend);
+    add(1, 100);
+    EXPECT_EQ(timer.GetStats().backend, CTimer::kHeapBackend);
+    add(CTimer::kHeapTimers, 100);
+    EXPECT_EQ(timer.GetStats().backend, CTimer::kWheelBackend);
+    EXPECT_EQ(timer.GetStats().population, CTimer::kHeapTimers + CTimer::kSmallTimers + 1);
+
+    // 任务执行完后切换回有序小数组
+    timer.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    auto stats = timer.GetStats();
+    EXPECT_EQ(fired, static_cast<int>(CTimer::kHeapTimers + CTimer::kSmallTimers + 1));
+    EXPECT_EQ(stats.backend, CTimer::kSmallBackend);
+    EXPECT_EQ(stats.population, 0u);
+    EXPECT_GE(stats.migrations, 3u);
+
+    // 关闭自动切换后固定使用时间轮
+    timer.SetAdaptive(false);
+    add(3, 20);
+    EXPECT_EQ(timer.GetStats().backend, CTimer::kWheelBackend);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    timer.Stop();
+    EXPECT_EQ(fired, static_cast<int>(CTimer::kHeapTimers + CTimer::kSmallTimers + 4));
+}
+
+TEST(testComp, testWorkBudget) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    timer.SetWorkBudget(10, 0);
+    std::vector<int> order;
+
+    // 同一时刻到期的 100 个任务每轮只执行 10 个，其余积压到后续轮次
+    CTimer::Tick_t deadline = CTimer::AddMilliSeconds(20);
+    for (int i = 0; i < 100; i++) {
+        timer.AddTimer(CTimer::TimerTask(deadline, [&order, i]() {
+            order.push_back(i);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }));
+    }
+    // 积压期间到期的任务排在积压任务之后
+    timer.AddTimer(CTimer::TimerTask(deadline + 2, [&order]() { order.push_back(100); }));
+    timer.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    timer.Stop();
+
+    auto stats = timer.GetStats();
+    ASSERT_EQ(order.size(), 101u);
+    EXPECT_EQ(order.back(), 100);
+    std::sort(order.begin(), order.end());
+    for (int i = 0; i <= 100; i++) {
+        EXPECT_EQ(order[i], i);
+    }
+    EXPECT_EQ(stats.backlog, 0u);
+    EXPECT_GE(stats.maxBacklog, 90u);
+    EXPECT_GE(stats.carryovers, 90u);
+    EXPECT_GT(stats.maxCarryoverLateness, 0u);
+}
+
+TEST(testComp, testRescheduleBacklog) {
+    auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1));
+    timer.SetWorkBudget(1, 0);
+    std::vector<CTimer::TimerId> ids(2);
+    std::vector<CTimer::Tick_t> firedAt[2];
+    std::atomic<CTimer::Tick_t> rescheduledTo(0);
+
+    // 两个任务同时到期，每轮只执行一个，先执行的任务把积压中的另一个任务延后
+    CTimer::Tick_t deadline = CTimer::AddMilliSeconds(50);
+    for (int i = 0; i < 2; i++) {
+        ids[i] = timer.AddTimer(CTimer::TimerTask(deadline, [&, i]() {
+            firedAt[i].push_back(CTimer::Now());
+            if (rescheduledTo == 0) {
+                rescheduledTo = CTimer::Now() + 50;
+                EXPECT_TRUE(timer.Reschedule(ids[1 - i], rescheduledTo));
+            }
+        }));
+    }
+    timer.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    timer.Stop();
+
+    // 积压的旧任务项不再执行，延后的任务只按新的到期时间执行一次
+    ASSERT_EQ(firedAt[0].size() + firedAt[1].size(), 2u);
+    ASSERT_EQ(firedAt[0].size(), 1u);
+    ASSERT_EQ(firedAt[1].size(), 1u);
+    EXPECT_GE(std::max(firedAt[0][0], firedAt[1][0]), rescheduledTo.load());
+    EXPECT_GE(timer.GetStats().carryovers, 1u);
+}
+
+TEST(testComp, testFarDeadline) {
+    for (bool adaptive : {true, false}) {
+        auto timer = CTimer::Timer<CTimer::TimerTask>(std::chrono::milliseconds(1), {4, 2});
+        timer.SetAdaptive(adaptive);
+        // 超出范围的到期时间不会回绕成很小的 tick
+        EXPECT_EQ(timer.ToTick(CTimer::kIdleDeadline - 1), CTimer::kIdleDeadline);
+        EXPECT_EQ(timer.ToTick(CTimer::kMaxExpireTime), CTimer::kMaxExpireTime);
+
+        std::atomic<int> fired(0);
+        timer.Start();
+        timer.AddTimer(CTimer::TimerTask(CTimer::kIdleDeadline - 1, [&fired]() { fired++; }));
+        timer.Schedule(10, [&fired]() { fired += 10; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto stats = timer.GetStats();
+        timer.Stop();
+        EXPECT_EQ(fired, 10);
+        // 永不到期的任务不会让定时器线程空转
+        EXPECT_LT(stats.wakeups, 10u);
+    }
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "timer.h"
+#include "timer_skiplist.h"
+#include <random>
+#include <thread>
+
+TEST(testComp, testSkipListOrder) {
+    CTimer::TimerSkipList<CTimer::TimerTask> list;
+    EXPECT_EQ(list.GetEarliestTime(), CTimer::Tick_t(CTimer::kInvalidTime));
+
+    std::vector<int> order;
+    CTimer::Tick_t ticks[] = {50, 10, 30, 10, 40, 20, 10};
+    for (int i = 0; i < 7; i++) {
+        list.AddTimer(CTimer::TimerTask(ticks[i], [&order, i]() { order.push_back(i); }));
+    }
+    EXPECT_EQ(list.GetEarliestTime(), 10u);
+
+    // 到期时间相同的任务按插入顺序弹出
+    size_t count = list.DrainExpired(30, [](CTimer::TimerTask &&task) { task.Run(); });
+    EXPECT_EQ(count, 5u);
+    EXPECT_EQ(order, (std::vector<int>{1, 3, 6, 5, 2}));
+    EXPECT_EQ(list.GetEarliestTime(), 40u);
+
+    // 访问期间插入的新任务
+    count = list.DrainExpired(40, [&list](CTimer::TimerTask &&task) {
+        list.AddTimer(CTimer::TimerTask(task.ExpireTime() + 100, []() {}));
+    });
+    EXPECT_EQ(count, 1u);
+
+    std::vector<CTimer::TimerTask> buffer;
+    EXPECT_EQ(list.DrainExpired(1000, buffer), 2u);
+    EXPECT_EQ(buffer[0].ExpireTime(), 50u);
+    EXPECT_EQ(buffer[1].ExpireTime(), 140u);
+    EXPECT_EQ(list.GetEarliestTime(), CTimer::Tick_t(CTimer::kInvalidTime));
+}
+
+TEST(testComp, testSkipListConcurrent) {
+    const int kProducers = 4;
+    const int kPerProducer = 20000;
+    CTimer::TimerSkipList<CTimer::TimerTask> list;
+    std::atomic<int> done(0);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&list, &done, p]() {
+            std::mt19937 rng(p);
+            for (int i = 0; i < kPerProducer; i++) {
+                list.AddTimer(CTimer::TimerTask(rng() % 100000, []() {}));
+            }
+            done++;
+        });
+    }
+
+    // 生产者插入的同时逐步弹出，不丢失也不重复
+    size_t popped = 0;
+    CTimer::Tick_t bound = 0;
+    while (done != kProducers) {
+        popped += list.DrainExpired(bound, [&bound](CTimer::TimerTask &&task) {
+            EXPECT_LE(task.ExpireTime(), bound);
+        });
+        bound = std::min<CTimer::Tick_t>(bound + 500, 50000);
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    // 插入结束后剩余任务按到期时间有序
+    CTimer::Tick_t last = 0;
+    popped += list.DrainExpired(100000, [&last](CTimer::TimerTask &&task) {
+        EXPECT_GE(task.ExpireTime(), last);
+        last = task.ExpireTime();
+    });
+    EXPECT_EQ(popped, size_t(kProducers * kPerProducer));
+    EXPECT_EQ(list.GetEarliestTime(), CTimer::Tick_t(CTimer::kInvalidTime));
+}
+
+TEST(testComp, testSkipListOverflow) {
+    // 时间轮只覆盖 64 个 tick，更晚的任务不加锁放入跳表
+    typedef CTimer::TimerSkipList<CTimer::TimerEntry<CTimer::TimerTask>> Overflow;
+    CTimer::Timer<CTimer::TimerTask, CTimer::RuntimeWheelLayout, Overflow> timer(std::chrono::milliseconds(1), {4, 2});
+    timer.SetAdaptive(false);
+    timer.Start();
+
+    std::atomic<int> fired(0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&timer, &fired, p]() {
+            for (int i = 0; i < 25; i++) {
+                timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(100 + (p * 25 + i) * 2), [&fired]() { fired++; }));
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    auto cancelled = timer.AddTimer(CTimer::TimerTask(CTimer::AddMilliSeconds(150), [&fired]() { fired += 1000; }));
+    EXPECT_TRUE(timer.Cancel(cancelled));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    timer.Stop();
+    EXPECT_EQ(fired, 100);
+    EXPECT_EQ(timer.GetStats().population, 0u);
+}
@@ -29,3 +29,79 @@ TEST(testComp, testComp1) {
         tw.RemoveTimer(task);
     }
 }
+
+TEST(testComp, testLazySlots) {
+    auto tw = CTimer::TimerWheel<CTimer::TimerTask>(0, 64);
+    EXPECT_EQ(tw.GetSlotCount(), 0u);
+
+    // 槽位在首次插入时创建
+    for (CTimer::Tick_t tick = 0; tick < 8; tick++) {
+        tw.AddTimer(CTimer::TimerTask(tick, []() {}), tick);
+    }
+    tw.AddTimer(CTimer::TimerTask(3, []() {}), 3);
+    EXPECT_EQ(tw.GetSlotCount(), 8u);
+
+    // 槽位清空后释放
+    EXPECT_EQ(tw.GetExpiredTimers(3).size(), 2u);
+    EXPECT_EQ(tw.GetSlotCount(), 7u);
+    for (CTimer::Tick_t tick = 0; tick < 8; tick++) {
+        tw.GetExpiredTimers(tick);
+    }
+    EXPECT_EQ(tw.GetSlotCount(), 0u);
+    EXPECT_TRUE(tw.GetExpiredTimers(10).empty());
+
+    // 非空时 Shrink 不释放，释放槽位数组后仍可继续插入
+    tw.AddTimer(CTimer::TimerTask(5, []() {}), 5);
+    tw.Shrink();
+    EXPECT_EQ(tw.GetSlotCount(), 1u);
+    EXPECT_EQ(tw.GetSlotEarliestTime(5), 5u);
+    EXPECT_EQ(tw.GetExpiredTimers(5).size(), 1u);
+    tw.Shrink();
+    EXPECT_EQ(tw.GetSlotCount(), 0u);
+    EXPECT_TRUE(tw.GetExpiredTimers(5).empty());
+    tw.AddTimer(CTimer::TimerTask(6, []() {}), 6);
+    EXPECT_EQ(tw.GetExpiredTimers(6).size(), 1u);
+}
+
+TEST(testComp, testOccupiedSlots) {
+    auto tw = CTimer::TimerWheel<CTimer::TimerTask>(0, 256);
+    EXPECT_EQ(tw.NextOccupiedSlot(0), -1);
+
+    tw.AddTimer(CTimer::TimerTask(70, []() {}), 70);
+    tw.AddTimer(CTimer::TimerTask(200, []() {}), 200);
+    EXPECT_EQ(tw.NextOccupiedSlot(0), 70);
+    EXPECT_EQ(tw.NextOccupiedSlot(70), 70);
+    EXPECT_EQ(tw.NextOccupiedSlot(71), 200);
+    // 越过末尾后从头查找
+    EXPECT_EQ(tw.NextOccupiedSlot(201), 70);
+    EXPECT_EQ(tw.GetSlotEarliestTime(200), 200u);
+
+    tw.GetExpiredTimers(70);
+    EXPECT_EQ(tw.NextOccupiedSlot(0), 200);
+    EXPECT_EQ(tw.NextOccupiedSlot(201), 200);
+}
+
+TEST(testComp, testDrainExpired) {
+    auto tw = CTimer::TimerWheel<CTimer::TimerTask>(0, 64);
+    int fired = 0;
+    for (int i = 0; i < 5; i++) {
+        tw.AddTimer(CTimer::TimerTask(5, [&fired]() { fired++; }), 5);
+    }
+
+    // 访问期间向同一槽位插入的任务留到下一圈
+    size_t count = tw.DrainExpired(5, [&tw](CTimer::TimerTask &&task) {
+        task.Run();
+        tw.AddTimer(std::move(task), 69);
+    });
+    EXPECT_EQ(count, 5u);
+    EXPECT_EQ(fired, 5);
+    EXPECT_EQ(tw.GetSlotCount(), 1u);
+
+    // 追加到调用方复用的缓冲区
+    std::vector<CTimer::TimerTask> buffer;
+    buffer.reserve(8);
+    EXPECT_EQ(tw.DrainExpired(69, buffer), 5u);
+    EXPECT_EQ(buffer.size(), 5u);
+    EXPECT_EQ(tw.GetSlotCount(), 0u);
+    EXPECT_EQ(tw.DrainExpired(69, buffer), 0u);
+}